@@ -0,0 +1,265 @@
+#include "head.h"
+#include "bignum.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define KARATSUBA_THRESHOLD 48
+#define PRODUCT_LEAF_SIZE 16
+
+/* Column-wise product. Sixteen products of limbs below 10^9 fit in 64 bits
+   next to the carry, so the column is only reduced once per sixteen terms. */
+static void multiply_base(const uint32_t *a, size_t an, const uint32_t *b, size_t bn, uint32_t *r) {
+    uint64_t carry = 0;
+
+    for (size_t k = 0; k + 1 < an + bn; k++) {
+        size_t first = k >= bn ? k - bn + 1 : 0;
+        size_t last = k < an ? k : an - 1;
+        uint64_t low = carry;
+        uint64_t high = 0;
+        unsigned pending = 0;
+
+        for (size_t i = first; i <= last; i++) {
+            low += (uint64_t)a[i] * b[k - i];
+            if (++pending == 16) {
+                uint64_t q = low / BIGNUM_BASE;
+                high += q;
+                low -= q * BIGNUM_BASE;
+                pending = 0;
+            }
+        }
+
+        uint64_t q = low / BIGNUM_BASE;
+        r[k] = (uint32_t)(low - q * BIGNUM_BASE);
+        carry = high + q;
+    }
+    r[an + bn - 1] = (uint32_t)carry;
+}
+
+static void add_into(uint32_t *dst, size_t dst_len, const uint32_t *src, size_t src_len) {
+    uint32_t carry = 0;
+    size_t i = 0;
+
+    for (; i < src_len; i++) {
+        uint32_t t = dst[i] + src[i] + carry;
+        carry = t >= BIGNUM_BASE;
+        dst[i] = carry ? t - BIGNUM_BASE : t;
+    }
+    for (; carry && i < dst_len; i++) {
+        uint32_t t = dst[i] + 1;
+        carry = t == BIGNUM_BASE;
+        dst[i] = carry ? 0 : t;
+    }
+}
+
+static void subtract_from(uint32_t *dst, size_t dst_len, const uint32_t *src, size_t src_len) {
+    uint32_t borrow = 0;
+    size_t i = 0;
+
+    for (; i < src_len; i++) {
+        uint32_t s = src[i] + borrow;
+        borrow = dst[i] < s;
+        dst[i] = borrow ? dst[i] + BIGNUM_BASE - s : dst[i] - s;
+    }
+    for (; borrow && i < dst_len; i++) {
+        borrow = dst[i] == 0;
+        dst[i] = borrow ? BIGNUM_BASE - 1 : dst[i] - 1;
+    }
+}
+
+static size_t trimmed_size(const uint32_t *limbs, size_t size) {
+    while (size > 1 && limbs[size - 1] == 0) size--;
+    return size;
+}
+
+static size_t karatsuba_scratch(size_t n) {
+    size_t total = 0;
+
+    while (n >= KARATSUBA_THRESHOLD) {
+        size_t k = n - n / 2;
+        total += 4 * (k + 1);
+        n = k + 1;
+    }
+    return total;
+}
+
+static void karatsuba(const uint32_t *a, const uint32_t *b, size_t n, uint32_t *r, uint32_t *scratch) {
+    if (n < KARATSUBA_THRESHOLD) {
+        multiply_base(a, n, b, n, r);
+        return;
+    }
+
+    size_t h = n / 2;
+    size_t k = n - h;
+    uint32_t *sa = scratch;
+    uint32_t *sb = sa + k + 1;
+    uint32_t *middle = sb + k + 1;
+
+    karatsuba(a, b, h, r, scratch);
+    karatsuba(a + h, b + h, k, r + 2 * h, scratch);
+
+    memcpy(sa, a + h, k * sizeof(uint32_t));
+    memcpy(sb, b + h, k * sizeof(uint32_t));
+    sa[k] = 0;
+    sb[k] = 0;
+    add_into(sa, k + 1, a, h);
+    add_into(sb, k + 1, b, h);
+
+    karatsuba(sa, sb, k + 1, middle, middle + 2 * (k + 1));
+    subtract_from(middle, 2 * (k + 1), r, 2 * h);
+    subtract_from(middle, 2 * (k + 1), r + 2 * h, 2 * k);
+    add_into(r + h, 2 * n - h, middle, trimmed_size(middle, 2 * (k + 1)));
+}
+
+static int multiply_limbs(const uint32_t *a, size_t an, const uint32_t *b, size_t bn, uint32_t *r) {
+    if (an < bn) {
+        const uint32_t *t = a; a = b; b = t;
+        size_t tn = an; an = bn; bn = tn;
+    }
+
+    if (bn < KARATSUBA_THRESHOLD) {
+        multiply_base(a, an, b, bn, r);
+        return SUCCESS;
+    }
+
+    uint32_t *scratch = (uint32_t*)malloc((2 * bn + karatsuba_scratch(bn)) * sizeof(uint32_t));
+    if (scratch == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    if (an == bn) {
+        karatsuba(a, b, bn, r, scratch);
+        free(scratch);
+        return SUCCESS;
+    }
+
+    uint32_t *chunk = scratch + karatsuba_scratch(bn);
+    int status = SUCCESS;
+    memset(r, 0, (an + bn) * sizeof(uint32_t));
+
+    for (size_t offset = 0; offset < an && status == SUCCESS; offset += bn) {
+        size_t m = an - offset < bn ? an - offset : bn;
+        if (m == bn) {
+            karatsuba(a + offset, b, bn, chunk, scratch);
+        } else {
+            status = multiply_limbs(b, bn, a + offset, m, chunk);
+        }
+        add_into(r + offset, an + bn - offset, chunk, m + bn);
+    }
+
+    free(scratch);
+    return status;
+}
+
+int bignum_from_u64(bignum_t *result, uint64_t value) {
+    result->limbs = (uint32_t*)malloc(3 * sizeof(uint32_t));
+    if (result->limbs == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    result->size = 0;
+    do {
+        result->limbs[result->size++] = (uint32_t)(value % BIGNUM_BASE);
+        value /= BIGNUM_BASE;
+    } while (value > 0);
+
+    return SUCCESS;
+}
+
+int bignum_multiply(const bignum_t *a, const bignum_t *b, bignum_t *result) {
+    size_t size = a->size + b->size;
+    uint32_t *limbs = (uint32_t*)malloc(size * sizeof(uint32_t));
+    if (limbs == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    int status = multiply_limbs(a->limbs, a->size, b->limbs, b->size, limbs);
+    if (status != SUCCESS) {
+        free(limbs);
+        return status;
+    }
+
+    result->limbs = limbs;
+    result->size = trimmed_size(limbs, size);
+    return SUCCESS;
+}
+
+int bignum_product(const uint32_t *factors, size_t count, bignum_t *result) {
+    if (count <= PRODUCT_LEAF_SIZE) {
+        result->limbs = (uint32_t*)malloc((count + 1) * sizeof(uint32_t));
+        if (result->limbs == NULL) {
+            return ERROR_MEMORY_ALLOCATION;
+        }
+
+        result->limbs[0] = 1;
+        result->size = 1;
+        for (size_t i = 0; i < count; i++) {
+            uint64_t carry = 0;
+            for (size_t j = 0; j < result->size; j++) {
+                uint64_t t = (uint64_t)result->limbs[j] * factors[i] + carry;
+                carry = t / BIGNUM_BASE;
+                result->limbs[j] = (uint32_t)(t - carry * BIGNUM_BASE);
+            }
+            if (carry) {
+                result->limbs[result->size++] = (uint32_t)carry;
+            }
+        }
+        return SUCCESS;
+    }
+
+    bignum_t left, right;
+    size_t half = count / 2;
+
+    int status = bignum_product(factors, half, &left);
+    if (status != SUCCESS) {
+        return status;
+    }
+
+    status = bignum_product(factors + half, count - half, &right);
+    if (status == SUCCESS) {
+        status = bignum_multiply(&left, &right, result);
+        bignum_free(&right);
+    }
+
+    bignum_free(&left);
+    return status;
+}
+
+int bignum_to_string(const bignum_t *a, char **result, size_t *length) {
+    char top[BIGNUM_BASE_DIGITS + 1];
+    size_t top_length = 0;
+    uint32_t value = a->limbs[a->size - 1];
+
+    do {
+        top[top_length++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    *length = top_length + (a->size - 1) * BIGNUM_BASE_DIGITS;
+    *result = (char*)malloc(*length + 1);
+    if (*result == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    char *out = *result;
+    while (top_length > 0) {
+        *out++ = top[--top_length];
+    }
+
+    for (size_t i = a->size - 1; i-- > 0; ) {
+        value = a->limbs[i];
+        for (int d = BIGNUM_BASE_DIGITS - 1; d >= 0; d--) {
+            out[d] = (char)('0' + value % 10);
+            value /= 10;
+        }
+        out += BIGNUM_BASE_DIGITS;
+    }
+
+    *out = '\0';
+    return SUCCESS;
+}
+
+void bignum_free(bignum_t *a) {
+    free(a->limbs);
+    a->limbs = NULL;
+    a->size = 0;
+}
@@ -0,0 +1,21 @@
+#ifndef BIGNUM_H
+#define BIGNUM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define BIGNUM_BASE 1000000000u
+#define BIGNUM_BASE_DIGITS 9
+
+typedef struct {
+    uint32_t *limbs;
+    size_t size;
+} bignum_t;
+
+int bignum_from_u64(bignum_t *result, uint64_t value);
+int bignum_multiply(const bignum_t *a, const bignum_t *b, bignum_t *result);
+int bignum_product(const uint32_t *factors, size_t count, bignum_t *result);
+int bignum_to_string(const bignum_t *a, char **result, size_t *length);
+void bignum_free(bignum_t *a);
+
+#endif
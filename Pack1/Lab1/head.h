@@ -2,6 +2,10 @@
 #define HEAD_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "bignum.h"
+#include "writer.h"
 
 typedef enum {
     SUCCESS = 0,
@@ -9,21 +13,45 @@ typedef enum {
     ERROR_NO_RESULTS = 2,
     ERROR_OUT_OF_RANGE = 3,
     ERROR_MEMORY_ALLOCATION = 4,
-    ERROR_NUMBER_TOO_LARGE = 5
+    ERROR_NUMBER_TOO_LARGE = 5,
+    ERROR_BUFFER_TOO_SMALL = 6
 } StatusCode;
 
+#define MULTIPLES_LIMIT 100
+#define DIGITS_BUFFER_SIZE 11
+#define POWER_TABLE_BASES 10
+#define POWER_TABLE_MAX_POWER 10
+
 int flag_h(int x, int **result, int *count);
-bool flag_p(int x);
+int flag_h_into(int x, int *buffer, int capacity, int *count);
+bool flag_p(uint64_t x);
+int flag_p_batch(const uint64_t *xs, size_t n, uint8_t *out);
 int flag_s(int x, char **result);
+int flag_s_into(int x, char *buffer, int capacity, int *length);
 int flag_e(int max_power, long long ***result);
+int power_table_fill(long long first_base, int base_count, int first_power, int power_count,
+                     long long *table, int *lengths);
+int flag_e_into(int max_power, long long *table, int capacity);
+int power_table_check(void);
 int flag_a(int x, long long *result);
 long long flag_f(int x);
+int flag_f_exact(int x, bignum_t *result);
+
+void write_multiples(writer_t *out, const int *numbers, int count);
+void write_prime_info(writer_t *out, uint64_t x, bool is_prime);
+void write_digits(writer_t *out, const char *digits, int count);
+void write_power_table_flat(writer_t *out, const long long *table, int max_power);
+void write_sum(writer_t *out, long long sum);
+void write_factorial(writer_t *out, long long factorial);
+int write_exact_factorial(writer_t *out, const bignum_t *factorial);
 
 void print_multiples(const int *numbers, int count);
-void print_prime_info(int x, bool is_prime);
+void print_prime_info(uint64_t x, bool is_prime);
 void print_digits(const char *digits, int count);
 void print_power_table(long long **table, int max_power);
+void print_power_table_flat(const long long *table, int max_power);
 void print_sum(long long sum);
 void print_factorial(long long factorial);
+void print_exact_factorial(const bignum_t *factorial);
 
 #endif
\ No newline at end of file
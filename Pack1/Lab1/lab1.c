@@ -3,106 +3,692 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <limits.h>
 
-int flag_h(int x, int **result, int *count) {
-    if (x <= 0 || x > 100) {
+typedef unsigned __int128 uint128_t;
+
+static const uint16_t small_primes[] = {
+    2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61, 67, 71,
+    73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127, 131, 137, 139, 149, 151, 157, 163, 167, 173,
+    179, 181, 191, 193, 197, 199, 211, 223, 227, 229, 233, 239, 241, 251
+};
+
+#define SMALL_PRIME_COUNT (sizeof(small_primes) / sizeof(small_primes[0]))
+
+int flag_h_into(int x, int *buffer, int capacity, int *count) {
+    if (x <= 0 || x > MULTIPLES_LIMIT) {
         return ERROR_NO_RESULTS;
     }
-    
-    *count = 100 / x;
-    if (*count == 0) {
+
+    *count = MULTIPLES_LIMIT / x;
+    if (*count > capacity) {
+        return ERROR_BUFFER_TOO_SMALL;
+    }
+
+    for (int i = 1; i <= *count; i++) {
+        buffer[i-1] = x * i;
+    }
+
+    return SUCCESS;
+}
+
+int flag_h(int x, int **result, int *count) {
+    if (x <= 0 || x > MULTIPLES_LIMIT) {
         return ERROR_NO_RESULTS;
     }
     
-    *result = (int*)malloc(*count * sizeof(int));
+    *result = (int*)malloc((MULTIPLES_LIMIT / x) * sizeof(int));
     if (*result == NULL) {
         return ERROR_MEMORY_ALLOCATION;
     }
     
-    for (int i = 1; i <= *count; i++) {
-        (*result)[i-1] = x * i;
+    return flag_h_into(x, *result, MULTIPLES_LIMIT / x, count);
+}
+
+
+static uint64_t montgomery_inverse(uint64_t n) {
+    uint64_t inverse = n;
+    for (int i = 0; i < 5; i++) {
+        inverse *= 2 - n * inverse;
     }
-    
-    return SUCCESS;
+    return inverse;
 }
 
+/* a * b / 2^64 mod n for a, b < n in Montgomery form; subtracting m * n avoids 128-bit overflow. */
+static uint64_t montgomery_multiply(uint64_t a, uint64_t b, uint64_t n, uint64_t n_inverse) {
+    uint128_t product = (uint128_t)a * b;
+    uint64_t m = (uint64_t)product * n_inverse;
+    uint64_t high = (uint64_t)(product >> 64);
+    uint64_t correction = (uint64_t)(((uint128_t)m * n) >> 64);
+    return high - correction + (n & ((uint64_t)0 - (high < correction)));
+}
+
+/*
+ * Deterministic Miller-Rabin bases: 2, 7 and 61 have no common strong pseudoprime under
+ * 2^32 (Jaeschke), Sinclair's seven bases none under 2^64.
+ */
+static const uint64_t bases_32[] = { 2, 7, 61 };
+static const uint64_t bases_64[] = { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+
+#define BASE_COUNT_32 (sizeof(bases_32) / sizeof(bases_32[0]))
+#define BASE_COUNT_64 (sizeof(bases_64) / sizeof(bases_64[0]))
+
+/* Miller-Rabin for odd n > 2 over the base set that is deterministic for its size. */
+static bool miller_rabin(uint64_t n) {
+    const uint64_t *bases = n >> 32 ? bases_64 : bases_32;
+    size_t base_count = n >> 32 ? BASE_COUNT_64 : BASE_COUNT_32;
+
+    uint64_t n_inverse = montgomery_inverse(n);
+    uint64_t one = (0 - n) % n;
+    uint64_t minus_one = n - one;
+    uint64_t r_squared = (uint64_t)((uint128_t)one * one % n);
+
+    uint64_t d = n - 1;
+    int shift = __builtin_ctzll(d);
+    d >>= shift;
+
+    for (size_t i = 0; i < base_count; i++) {
+        uint64_t a = bases[i] % n;
+        if (a == 0) {
+            continue;
+        }
 
-bool flag_p(int x) {
+        uint64_t base = montgomery_multiply(a, r_squared, n, n_inverse);
+        uint64_t x = one;
+        for (uint64_t e = d; e > 0; e >>= 1) {
+            if (e & 1) {
+                x = montgomery_multiply(x, base, n, n_inverse);
+            }
+            base = montgomery_multiply(base, base, n, n_inverse);
+        }
+
+        if (x == one || x == minus_one) {
+            continue;
+        }
+
+        bool witness = true;
+        for (int r = 1; r < shift; r++) {
+            x = montgomery_multiply(x, x, n, n_inverse);
+            if (x == minus_one) {
+                witness = false;
+                break;
+            }
+        }
+        if (witness) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+bool flag_p(uint64_t x) {
     if (x <= 1) return false;
-    if (x == 2) return true;
-    if (x % 2 == 0) return false;
     
-    for (int i = 3; i * i <= x; i += 2) {
-        if (x % i == 0) {
-            return false;
+    for (size_t i = 0; i < SMALL_PRIME_COUNT; i++) {
+        if (x == small_primes[i]) return true;
+        if (x % small_primes[i] == 0) return false;
+    }
+    
+    uint64_t largest = small_primes[SMALL_PRIME_COUNT - 1];
+    if (x < largest * largest) {
+        return true;
+    }
+    
+    return miller_rabin(x);
+}
+
+
+#define SCREEN_BLOCK 256
+
+/* Ends of the screening passes in small_primes; survivors are packed between passes. */
+static const size_t screen_passes[] = { 6, 18, SMALL_PRIME_COUNT };
+
+#define SCREEN_PASS_COUNT (sizeof(screen_passes) / sizeof(screen_passes[0]))
+
+typedef struct {
+    uint64_t inverse[SMALL_PRIME_COUNT];
+    uint64_t bound[SMALL_PRIME_COUNT];
+} screen_table_t;
+
+/*
+ * Branch-free divisibility test for odd p: p divides x exactly when
+ * x * p^-1 mod 2^64 <= (2^64 - 1) / p.
+ */
+static void screen_table_init(screen_table_t *table) {
+    for (size_t k = 1; k < SMALL_PRIME_COUNT; k++) {
+        table->inverse[k] = montgomery_inverse(small_primes[k]);
+        table->bound[k] = UINT64_MAX / small_primes[k];
+    }
+}
+
+static void mark_multiples(const uint64_t *values, size_t count, const screen_table_t *table,
+                           size_t first, size_t last, uint8_t *composite) {
+    for (size_t k = first; k < last; k++) {
+        uint64_t inverse = table->inverse[k];
+        uint64_t bound = table->bound[k];
+        for (size_t i = 0; i < count; i++) {
+            composite[i] |= (uint8_t)(values[i] * inverse <= bound);
+        }
+    }
+}
+
+static bool is_small_prime(uint64_t x) {
+    for (size_t i = 0; i < SMALL_PRIME_COUNT; i++) {
+        if (x == small_primes[i]) return true;
+    }
+    return false;
+}
+
+/*
+ * Marks the lanes of block that have a prime factor below 256. Each pass tests a range of
+ * small_primes and the lanes that survive it are packed together, so the long tail of the
+ * table runs on few lanes. The small primes themselves divide by their own test, so values
+ * below 256 are fixed up at the end.
+ */
+static void screen_block(const uint64_t *block, size_t count, const screen_table_t *table, uint8_t *composite) {
+    uint64_t values[SCREEN_BLOCK];
+    uint8_t marks[SCREEN_BLOCK];
+    uint16_t lanes[SCREEN_BLOCK];
+    size_t live = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        composite[i] = (uint8_t)((block[i] & 1) == 0);
+        values[live] = block[i];
+        lanes[live] = (uint16_t)i;
+        live += !composite[i];
+    }
+
+    size_t first = 1;
+    for (size_t pass = 0; pass < SCREEN_PASS_COUNT; pass++) {
+        memset(marks, 0, live);
+        mark_multiples(values, live, table, first, screen_passes[pass], marks);
+
+        size_t kept = 0;
+        for (size_t j = 0; j < live; j++) {
+            composite[lanes[j]] = marks[j];
+            values[kept] = values[j];
+            lanes[kept] = lanes[j];
+            kept += !marks[j];
+        }
+        live = kept;
+        first = screen_passes[pass];
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (block[i] < 256) {
+            composite[i] = !is_small_prime(block[i]);
         }
     }
+}
+
+
+#define STRONG_TEST_LANES 4
+
+static uint64_t subtract_mod(uint64_t a, uint64_t b, uint64_t n) {
+    return a - b + (n & ((uint64_t)0 - (a < b)));
+}
+
+static uint64_t double_mod(uint64_t a, uint64_t n) {
+    uint64_t sum = a + a;
+    return sum - (n & ((uint64_t)0 - ((sum < a) | (sum >= n))));
+}
+
+/*
+ * Strong probable-prime test to base 2 on STRONG_TEST_LANES odd moduli at once. The
+ * Montgomery chains are independent, so interleaving them hides the multiply latency, and
+ * the exponent bits are applied with masks instead of branches. Multiplying by the base
+ * is a modular doubling.
+ */
+static void strong_test_lanes(const uint64_t *n, bool *passed) {
+    uint64_t n_inverse[STRONG_TEST_LANES], one[STRONG_TEST_LANES], minus_one[STRONG_TEST_LANES];
+    uint64_t d[STRONG_TEST_LANES], x[STRONG_TEST_LANES];
+    int shift[STRONG_TEST_LANES];
+    int top = 0;
+
+    for (int l = 0; l < STRONG_TEST_LANES; l++) {
+        n_inverse[l] = montgomery_inverse(n[l]);
+        one[l] = (0 - n[l]) % n[l];
+        minus_one[l] = n[l] - one[l];
+        shift[l] = __builtin_ctzll(n[l] - 1);
+        d[l] = (n[l] - 1) >> shift[l];
+        x[l] = one[l];
+        int bits = 64 - __builtin_clzll(d[l]);
+        top = bits > top ? bits : top;
+    }
+
+    for (int bit = top - 1; bit >= 0; bit--) {
+        for (int l = 0; l < STRONG_TEST_LANES; l++) {
+            uint64_t square = montgomery_multiply(x[l], x[l], n[l], n_inverse[l]);
+            uint64_t product = double_mod(square, n[l]);
+            uint64_t select = (uint64_t)0 - ((d[l] >> bit) & 1);
+            x[l] = square ^ ((square ^ product) & select);
+        }
+    }
+
+    int max_shift = 0;
+    for (int l = 0; l < STRONG_TEST_LANES; l++) {
+        passed[l] = x[l] == one[l] || x[l] == minus_one[l];
+        max_shift = shift[l] > max_shift ? shift[l] : max_shift;
+    }
+
+    for (int r = 1; r < max_shift; r++) {
+        for (int l = 0; l < STRONG_TEST_LANES; l++) {
+            if (!passed[l] && r < shift[l]) {
+                x[l] = montgomery_multiply(x[l], x[l], n[l], n_inverse[l]);
+                passed[l] = x[l] == minus_one[l];
+            }
+        }
+    }
+}
+
+/* 32-bit Montgomery product a * b / 2^32 mod n for odd n < 2^32; n_inverse is n^-1 mod 2^32. */
+static uint32_t montgomery_multiply_32(uint32_t a, uint32_t b, uint32_t n, uint32_t n_inverse) {
+    uint64_t product = (uint64_t)a * b;
+    uint32_t m = (uint32_t)product * n_inverse;
+    uint32_t high = (uint32_t)(product >> 32);
+    uint32_t correction = (uint32_t)(((uint64_t)m * n) >> 32);
+    return high - correction + (n & ((uint32_t)0 - (high < correction)));
+}
+
+/* strong_test_lanes for moduli below 2^32, where the Montgomery products fit in 64 bits. */
+static void strong_test_lanes_32(const uint64_t *n64, bool *passed) {
+    uint32_t n[STRONG_TEST_LANES], n_inverse[STRONG_TEST_LANES], one[STRONG_TEST_LANES];
+    uint32_t minus_one[STRONG_TEST_LANES], d[STRONG_TEST_LANES], x[STRONG_TEST_LANES];
+    int shift[STRONG_TEST_LANES];
+    int top = 0;
+
+    for (int l = 0; l < STRONG_TEST_LANES; l++) {
+        n[l] = (uint32_t)n64[l];
+        n_inverse[l] = (uint32_t)montgomery_inverse(n[l]);
+        one[l] = (uint32_t)((UINT64_C(1) << 32) % n[l]);
+        minus_one[l] = n[l] - one[l];
+        shift[l] = __builtin_ctz(n[l] - 1);
+        d[l] = (n[l] - 1) >> shift[l];
+        x[l] = one[l];
+        int bits = 32 - __builtin_clz(d[l]);
+        top = bits > top ? bits : top;
+    }
+
+    for (int bit = top - 1; bit >= 0; bit--) {
+        for (int l = 0; l < STRONG_TEST_LANES; l++) {
+            uint32_t square = montgomery_multiply_32(x[l], x[l], n[l], n_inverse[l]);
+            uint32_t product = square + square;
+            product -= n[l] & ((uint32_t)0 - ((product < square) | (product >= n[l])));
+            uint32_t select = (uint32_t)0 - ((d[l] >> bit) & 1);
+            x[l] = square ^ ((square ^ product) & select);
+        }
+    }
+
+    int max_shift = 0;
+    for (int l = 0; l < STRONG_TEST_LANES; l++) {
+        passed[l] = x[l] == one[l] || x[l] == minus_one[l];
+        max_shift = shift[l] > max_shift ? shift[l] : max_shift;
+    }
+
+    for (int r = 1; r < max_shift; r++) {
+        for (int l = 0; l < STRONG_TEST_LANES; l++) {
+            if (!passed[l] && r < shift[l]) {
+                x[l] = montgomery_multiply_32(x[l], x[l], n[l], n_inverse[l]);
+                passed[l] = x[l] == minus_one[l];
+            }
+        }
+    }
+}
+
+/*
+ * Runs the base-2 test over the candidates in batches of STRONG_TEST_LANES and compacts
+ * candidates to the moduli that pass. Returns how many remain.
+ */
+static size_t strong_test_candidates(const uint64_t *xs, size_t *candidates, size_t count, bool narrow) {
+    size_t kept = 0;
+    for (size_t j = 0; j < count; j += STRONG_TEST_LANES) {
+        uint64_t moduli[STRONG_TEST_LANES];
+        bool passed[STRONG_TEST_LANES];
+        for (int l = 0; l < STRONG_TEST_LANES; l++) {
+            moduli[l] = xs[candidates[j + l < count ? j + l : count - 1]];
+        }
+        
+        if (narrow) {
+            strong_test_lanes_32(moduli, passed);
+        } else {
+            strong_test_lanes(moduli, passed);
+        }
+        
+        for (int l = 0; l < STRONG_TEST_LANES && j + l < count; l++) {
+            candidates[kept] = candidates[j + l];
+            kept += passed[l];
+        }
+    }
+    return kept;
+}
+
+/* Jacobi symbol (a / n) for odd n. */
+static int jacobi(uint64_t a, uint64_t n) {
+    int result = 1;
+    a %= n;
+    while (a != 0) {
+        int twos = __builtin_ctzll(a);
+        a >>= twos;
+        if ((twos & 1) && ((n & 7) == 3 || (n & 7) == 5)) {
+            result = -result;
+        }
+        if ((a & 3) == 3 && (n & 3) == 3) {
+            result = -result;
+        }
+        uint64_t r = n % a;
+        n = a;
+        a = r;
+    }
+    return n == 1 ? result : 0;
+}
+
+static bool is_square(uint64_t n) {
+    uint64_t root = 0;
+    for (uint64_t bit = UINT64_C(1) << 31; bit != 0; bit >>= 1) {
+        uint64_t trial = root | bit;
+        if (trial * trial <= n) {
+            root = trial;
+        }
+    }
+    return root * root == n;
+}
+
+/*
+ * Smallest P >= 3 with ((P^2 - 4) / n) = -1, the parameter of the extra strong Lucas test
+ * with Q = 1, or 0 when the search proves n composite. A square never gives -1, so it is
+ * checked once the first few P have failed.
+ */
+static uint64_t lucas_parameter(uint64_t n) {
+    for (uint64_t p = 3; ; p++) {
+        int symbol = jacobi(p * p - 4, n);
+        if (symbol == -1) {
+            return p;
+        }
+        if (symbol == 0 || (p == 8 && is_square(n))) {
+            return 0;
+        }
+    }
+}
+
+/*
+ * Extra strong Lucas test with Q = 1 on STRONG_TEST_LANES odd moduli at once. With
+ * n + 1 = s * 2^t, V_s and V_{s+1} come from a Montgomery ladder (two products per bit,
+ * selected with masks), U_s = 0 is checked as 2 V_{s+1} = P V_s, and the V_{s * 2^r} are
+ * squared out. Leading zero bits keep the ladder at (V_0, V_1), so lanes with shorter s
+ * need no guard. n + 1 does not wrap: 2^64 - 1 is divisible by 3 and never reaches here.
+ */
+static void lucas_test_lanes(const uint64_t *n, const uint64_t *parameter, bool *passed) {
+    uint64_t n_inverse[STRONG_TEST_LANES], two[STRONG_TEST_LANES], p[STRONG_TEST_LANES];
+    uint64_t s[STRONG_TEST_LANES], v[STRONG_TEST_LANES], w[STRONG_TEST_LANES];
+    int shift[STRONG_TEST_LANES];
+    int top = 0;
+
+    for (int l = 0; l < STRONG_TEST_LANES; l++) {
+        uint64_t one = (0 - n[l]) % n[l];
+        n_inverse[l] = montgomery_inverse(n[l]);
+        two[l] = double_mod(one, n[l]);
+        p[l] = 0;
+        for (uint64_t k = 0; k < parameter[l]; k++) {
+            p[l] = subtract_mod(p[l], n[l] - one, n[l]);
+        }
+        shift[l] = __builtin_ctzll(n[l] + 1);
+        s[l] = (n[l] + 1) >> shift[l];
+        v[l] = two[l];
+        w[l] = p[l];
+        int bits = 64 - __builtin_clzll(s[l]);
+        top = bits > top ? bits : top;
+    }
+
+    for (int bit = top - 1; bit >= 0; bit--) {
+        for (int l = 0; l < STRONG_TEST_LANES; l++) {
+            uint64_t select = (uint64_t)0 - ((s[l] >> bit) & 1);
+            uint64_t product = subtract_mod(montgomery_multiply(v[l], w[l], n[l], n_inverse[l]), p[l], n[l]);
+            uint64_t base = v[l] ^ ((v[l] ^ w[l]) & select);
+            uint64_t square = subtract_mod(montgomery_multiply(base, base, n[l], n_inverse[l]), two[l], n[l]);
+            v[l] = square ^ ((square ^ product) & select);
+            w[l] = product ^ ((product ^ square) & select);
+        }
+    }
+
+    int max_shift = 0;
+    for (int l = 0; l < STRONG_TEST_LANES; l++) {
+        uint64_t pv = montgomery_multiply(p[l], v[l], n[l], n_inverse[l]);
+        bool u_zero = double_mod(w[l], n[l]) == pv;
+        passed[l] = u_zero && (v[l] == two[l] || v[l] == n[l] - two[l]);
+        max_shift = shift[l] > max_shift ? shift[l] : max_shift;
+    }
+
+    for (int r = 0; r < max_shift - 1; r++) {
+        for (int l = 0; l < STRONG_TEST_LANES; l++) {
+            if (!passed[l] && r < shift[l] - 1) {
+                passed[l] = v[l] == 0;
+                v[l] = subtract_mod(montgomery_multiply(v[l], v[l], n[l], n_inverse[l]), two[l], n[l]);
+            }
+        }
+    }
+}
+
+/* Compacts candidates to the moduli that pass the extra strong Lucas test. */
+static size_t lucas_test_candidates(const uint64_t *xs, size_t *candidates, size_t count) {
+    uint64_t parameters[SCREEN_BLOCK];
+    size_t kept = 0;
+    for (size_t j = 0; j < count; j++) {
+        candidates[kept] = candidates[j];
+        parameters[kept] = lucas_parameter(xs[candidates[j]]);
+        kept += parameters[kept] != 0;
+    }
+    count = kept;
+
+    kept = 0;
+    for (size_t j = 0; j < count; j += STRONG_TEST_LANES) {
+        uint64_t moduli[STRONG_TEST_LANES], lane_parameters[STRONG_TEST_LANES];
+        bool passed[STRONG_TEST_LANES];
+        for (int l = 0; l < STRONG_TEST_LANES; l++) {
+            size_t index = j + l < count ? j + l : count - 1;
+            moduli[l] = xs[candidates[index]];
+            lane_parameters[l] = parameters[index];
+        }
+
+        lucas_test_lanes(moduli, lane_parameters, passed);
+
+        for (int l = 0; l < STRONG_TEST_LANES && j + l < count; l++) {
+            candidates[kept] = candidates[j + l];
+            kept += passed[l];
+        }
+    }
+    return kept;
+}
+
+
+/*
+ * Classifies xs in blocks of SCREEN_BLOCK: small-prime screening, then for the survivors
+ * above 251^2 a base-2 strong test followed by the extra strong Lucas test (BPSW). No
+ * composite below 2^64 passes both, so the result matches flag_p, and a prime costs about
+ * three exponentiations instead of the seven bases of the scalar test.
+ */
+int flag_p_batch(const uint64_t *xs, size_t n, uint8_t *out) {
+    if ((xs == NULL || out == NULL) && n > 0) {
+        return ERROR_INVALID_INPUT;
+    }
     
-    return true;
+    uint64_t largest = small_primes[SMALL_PRIME_COUNT - 1];
+    screen_table_t table;
+    screen_table_init(&table);
+    uint8_t composite[SCREEN_BLOCK];
+    size_t candidates_32[SCREEN_BLOCK];
+    size_t candidates_64[SCREEN_BLOCK];
+    
+    for (size_t start = 0; start < n; start += SCREEN_BLOCK) {
+        size_t count = n - start < SCREEN_BLOCK ? n - start : SCREEN_BLOCK;
+        screen_block(xs + start, count, &table, composite);
+        
+        size_t count_32 = 0;
+        size_t count_64 = 0;
+        for (size_t i = 0; i < count; i++) {
+            uint64_t x = xs[start + i];
+            out[start + i] = (uint8_t)(!composite[i] && x < largest * largest);
+            if (!composite[i] && x >= largest * largest) {
+                if (x >> 32) {
+                    candidates_64[count_64++] = start + i;
+                } else {
+                    candidates_32[count_32++] = start + i;
+                }
+            }
+        }
+        
+        count_32 = strong_test_candidates(xs, candidates_32, count_32, true);
+        count_32 = lucas_test_candidates(xs, candidates_32, count_32);
+        count_64 = strong_test_candidates(xs, candidates_64, count_64, false);
+        count_64 = lucas_test_candidates(xs, candidates_64, count_64);
+        
+        for (size_t j = 0; j < count_32; j++) {
+            out[candidates_32[j]] = 1;
+        }
+        for (size_t j = 0; j < count_64; j++) {
+            out[candidates_64[j]] = 1;
+        }
+    }
+    
+    return SUCCESS;
 }
 
 
-int flag_s(int x, char **result) {
+int flag_s_into(int x, char *buffer, int capacity, int *length) {
     if (x < 0) {
         return ERROR_INVALID_INPUT;
     }
     
-    if (x == 0) {
-        *result = (char*)malloc(2 * sizeof(char));
-        if (*result == NULL) return ERROR_MEMORY_ALLOCATION;
-        (*result)[0] = '0';
-        (*result)[1] = '\0';
-        return SUCCESS;
+    *length = (int)decimal_length((uint64_t)x);
+    if (*length + 1 > capacity) {
+        return ERROR_BUFFER_TOO_SMALL;
     }
     
-    int temp = x;
-    int length = 0;
-    while (temp > 0) {
-        length++;
-        temp /= 10;
+    format_decimal((uint64_t)x, buffer);
+    buffer[*length] = '\0';
+    
+    return SUCCESS;
+}
+
+int flag_s(int x, char **result) {
+    if (x < 0) {
+        return ERROR_INVALID_INPUT;
     }
     
-    *result = (char*)malloc((length + 1) * sizeof(char));
+    *result = (char*)malloc(DIGITS_BUFFER_SIZE * sizeof(char));
     if (*result == NULL) {
         return ERROR_MEMORY_ALLOCATION;
     }
     
-    temp = x;
-    for (int i = length - 1; i >= 0; i--) {
-        (*result)[i] = '0' + (temp % 10);
-        temp /= 10;
+    int length;
+    return flag_s_into(x, *result, DIGITS_BUFFER_SIZE, &length);
+}
+
+
+/*
+ * Fills row i with first_base + i raised to the powers first_power .. first_power + power_count - 1.
+ * A row stops before the first power that overflows; lengths[i] receives its length.
+ */
+int power_table_fill(long long first_base, int base_count, int first_power, int power_count,
+                     long long *table, int *lengths) {
+    if (base_count < 1 || first_power < 0 || power_count < 1) {
+        return ERROR_INVALID_INPUT;
+    }
+    
+    if (first_base > LLONG_MAX - (base_count - 1)) {
+        return ERROR_OUT_OF_RANGE;
+    }
+    
+    for (int i = 0; i < base_count; i++) {
+        long long base = first_base + i;
+        long long power = 1;
+        bool overflow = false;
+        int j = 0;
+        
+        for (int k = 0; k < first_power && !overflow; k++) {
+            overflow = __builtin_mul_overflow(power, base, &power);
+        }
+        
+        for (; j < power_count && !overflow; j++) {
+            table[(size_t)i * power_count + j] = power;
+            overflow = __builtin_mul_overflow(power, base, &power);
+        }
+        lengths[i] = j;
+    }
+    
+    return SUCCESS;
+}
+
+/* Powers 1..10 of the bases 1..10, so -e only copies rows; power_table_check verifies it. */
+static const long long default_power_table[POWER_TABLE_BASES][POWER_TABLE_MAX_POWER] = {
+    { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+    { 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024 },
+    { 3, 9, 27, 81, 243, 729, 2187, 6561, 19683, 59049 },
+    { 4, 16, 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576 },
+    { 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125, 9765625 },
+    { 6, 36, 216, 1296, 7776, 46656, 279936, 1679616, 10077696, 60466176 },
+    { 7, 49, 343, 2401, 16807, 117649, 823543, 5764801, 40353607, 282475249 },
+    { 8, 64, 512, 4096, 32768, 262144, 2097152, 16777216, 134217728, 1073741824 },
+    { 9, 81, 729, 6561, 59049, 531441, 4782969, 43046721, 387420489, 3486784401LL },
+    { 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000, 10000000000LL }
+};
+
+/* Compares the constant default table with power_table_fill(1, 10, 1, 10). */
+int power_table_check(void) {
+    long long table[POWER_TABLE_BASES * POWER_TABLE_MAX_POWER];
+    int lengths[POWER_TABLE_BASES];
+    
+    int status = power_table_fill(1, POWER_TABLE_BASES, 1, POWER_TABLE_MAX_POWER, table, lengths);
+    if (status != SUCCESS) {
+        return status;
+    }
+    
+    for (int i = 0; i < POWER_TABLE_BASES; i++) {
+        if (lengths[i] != POWER_TABLE_MAX_POWER ||
+            memcmp(table + i * POWER_TABLE_MAX_POWER, default_power_table[i], sizeof(default_power_table[i])) != 0) {
+            return ERROR_INVALID_INPUT;
+        }
     }
-    (*result)[length] = '\0';
     
     return SUCCESS;
 }
 
+int flag_e_into(int max_power, long long *table, int capacity) {
+    if (max_power < 1 || max_power > POWER_TABLE_MAX_POWER) {
+        return ERROR_OUT_OF_RANGE;
+    }
+    
+    if (POWER_TABLE_BASES * max_power > capacity) {
+        return ERROR_BUFFER_TOO_SMALL;
+    }
+    
+    for (int i = 0; i < POWER_TABLE_BASES; i++) {
+        memcpy(table + i * max_power, default_power_table[i], max_power * sizeof(long long));
+    }
+    
+    return SUCCESS;
+}
 
 int flag_e(int max_power, long long ***result) {
-    if (max_power < 1 || max_power > 10) {
+    if (max_power < 1 || max_power > POWER_TABLE_MAX_POWER) {
         return ERROR_OUT_OF_RANGE;
     }
     
-    *result = (long long**)malloc(10 * sizeof(long long*));
+    *result = (long long**)malloc(POWER_TABLE_BASES * sizeof(long long*));
     if (*result == NULL) {
         return ERROR_MEMORY_ALLOCATION;
     }
     
-    for (int i = 0; i < 10; i++) {
-        (*result)[i] = (long long*)malloc(max_power * sizeof(long long));
-        if ((*result)[i] == NULL) {
-            for (int j = 0; j < i; j++) {
-                free((*result)[j]);
-            }
-            free(*result);
-            return ERROR_MEMORY_ALLOCATION;
-        }
-        
-        long long power = 1;
-        for (int j = 0; j < max_power; j++) {
-            power *= (i + 1);
-            (*result)[i][j] = power;
-        }
+    long long *rows = (long long*)malloc(POWER_TABLE_BASES * max_power * sizeof(long long));
+    if (rows == NULL) {
+        free(*result);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    
+    flag_e_into(max_power, rows, POWER_TABLE_BASES * max_power);
+    for (int i = 0; i < POWER_TABLE_BASES; i++) {
+        (*result)[i] = rows + i * max_power;
     }
     
     return SUCCESS;
@@ -133,59 +719,253 @@ long long flag_f(int x) {
     return result;
 }
 
+#define FACTORIAL_MAX 1000000
+#define FACTORIAL_DIRECT_LIMIT 20
 
-void print_multiples(const int *numbers, int count) {
+static size_t swing_factors(uint32_t n, const uint32_t *primes, size_t prime_count, uint32_t *factors) {
+    size_t count = 0;
+    uint32_t group = 1;
+
+    for (size_t i = 0; i < prime_count && primes[i] <= n; i++) {
+        uint32_t p = primes[i];
+        uint32_t power = 1;
+
+        for (uint32_t q = n / p; q > 0; q /= p) {
+            if (q & 1) power *= p;
+        }
+        if (power == 1) continue;
+
+        if ((uint64_t)group * power >= BIGNUM_BASE) {
+            factors[count++] = group;
+            group = power;
+        } else {
+            group *= power;
+        }
+    }
+
+    if (group > 1) factors[count++] = group;
+    return count;
+}
+
+static int factorial_swing(uint32_t n, const uint32_t *primes, size_t prime_count, uint32_t *factors, bignum_t *result) {
+    if (n <= FACTORIAL_DIRECT_LIMIT) {
+        uint64_t product = 1;
+        for (uint32_t i = 2; i <= n; i++) {
+            product *= i;
+        }
+        return bignum_from_u64(result, product);
+    }
+
+    bignum_t half, square, swing;
+
+    int status = factorial_swing(n / 2, primes, prime_count, factors, &half);
+    if (status != SUCCESS) {
+        return status;
+    }
+
+    status = bignum_multiply(&half, &half, &square);
+    bignum_free(&half);
+    if (status != SUCCESS) {
+        return status;
+    }
+
+    status = bignum_product(factors, swing_factors(n, primes, prime_count, factors), &swing);
+    if (status == SUCCESS) {
+        status = bignum_multiply(&square, &swing, result);
+        bignum_free(&swing);
+    }
+
+    bignum_free(&square);
+    return status;
+}
+
+int flag_f_exact(int x, bignum_t *result) {
+    if (x < 0) return ERROR_INVALID_INPUT;
+    if (x > FACTORIAL_MAX) return ERROR_NUMBER_TOO_LARGE;
+
+    uint32_t n = (uint32_t)x;
+    if (n <= FACTORIAL_DIRECT_LIMIT) {
+        return factorial_swing(n, NULL, 0, NULL, result);
+    }
+
+    uint8_t *composite = (uint8_t*)calloc(n + 1, 1);
+    uint32_t *primes = (uint32_t*)malloc((n / 2 + 1) * sizeof(uint32_t));
+    if (composite == NULL || primes == NULL) {
+        free(composite);
+        free(primes);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    size_t prime_count = 0;
+    for (uint32_t i = 2; i <= n; i++) {
+        if (composite[i]) continue;
+        primes[prime_count++] = i;
+        for (uint64_t j = (uint64_t)i * i; j <= n; j += i) {
+            composite[j] = 1;
+        }
+    }
+    free(composite);
+
+    uint32_t *factors = (uint32_t*)malloc(prime_count * sizeof(uint32_t));
+    if (factors == NULL) {
+        free(primes);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    int status = factorial_swing(n, primes, prime_count, factors, result);
+    free(factors);
+    free(primes);
+    return status;
+}
+
+
+void write_multiples(writer_t *out, const int *numbers, int count) {
     if (count == 0) {
-        printf("No multiples found\n");
+        writer_puts(out, "No multiples found\n");
         return;
     }
     
-    printf("Multiples of the number up to 100: ");
+    writer_puts(out, "Multiples of the number up to 100: ");
     for (int i = 0; i < count; i++) {
-        printf("%d", numbers[i]);
-        if (i < count - 1) printf(", ");
+        writer_int(out, numbers[i]);
+        if (i < count - 1) writer_write(out, ", ", 2);
     }
-    printf("\n");
+    writer_char(out, '\n');
 }
 
-
-void print_prime_info(int x, bool is_prime_flag) {
+void write_prime_info(writer_t *out, uint64_t x, bool is_prime_flag) {
+    writer_uint(out, x);
     if (x <= 1) {
-        printf("%d is neither prime nor composite\n", x);
+        writer_puts(out, " is neither prime nor composite\n");
     } else if (is_prime_flag) {
-        printf("%d is a prime number\n", x);
+        writer_puts(out, " is a prime number\n");
     } else {
-        printf("%d is a composite number\n", x);
+        writer_puts(out, " is a composite number\n");
     }
 }
 
-
-void print_digits(const char *digits, int count) {
-    printf("Digits of the number: ");
+void write_digits(writer_t *out, const char *digits, int count) {
+    writer_puts(out, "Digits of the number: ");
     for (int i = 0; i < count; i++) {
-        printf("%c", digits[i]);
-        if (i < count - 1) printf(" ");
+        writer_char(out, digits[i]);
+        if (i < count - 1) writer_char(out, ' ');
+    }
+    writer_char(out, '\n');
+}
+
+static void write_power_row(writer_t *out, int base, const long long *powers, int max_power) {
+    writer_write(out, "    ", base < 10 ? 3 : 2);
+    writer_int(out, base);
+    writer_write(out, " | ", 3);
+    for (int j = 0; j < max_power; j++) {
+        writer_int(out, powers[j]);
+        writer_char(out, ' ');
+    }
+    writer_char(out, '\n');
+}
+
+void write_power_table_flat(writer_t *out, const long long *table, int max_power) {
+    writer_puts(out, "Power table (numbers 1-10):\nBase | Powers\n");
+    for (int i = 0; i < POWER_TABLE_BASES; i++) {
+        write_power_row(out, i + 1, table + i * max_power, max_power);
     }
-    printf("\n");
+}
+
+void write_sum(writer_t *out, long long sum) {
+    writer_puts(out, "Sum of numbers from 1 to N: ");
+    writer_int(out, sum);
+    writer_char(out, '\n');
+}
+
+void write_factorial(writer_t *out, long long factorial) {
+    writer_puts(out, "Factorial: ");
+    writer_int(out, factorial);
+    writer_char(out, '\n');
+}
+
+int write_exact_factorial(writer_t *out, const bignum_t *factorial) {
+    char *digits = NULL;
+    size_t length = 0;
+
+    int status = bignum_to_string(factorial, &digits, &length);
+    if (status != SUCCESS) {
+        writer_puts(out, "Error: Memory allocation failed\n");
+        return status;
+    }
+
+    writer_puts(out, "Factorial: ");
+    writer_write(out, digits, length);
+    writer_char(out, '\n');
+    free(digits);
+    return SUCCESS;
+}
+
+
+#define PRINT_BUFFER_SIZE 1024
+
+void print_multiples(const int *numbers, int count) {
+    char buffer[PRINT_BUFFER_SIZE];
+    writer_t out;
+    writer_init(&out, stdout, buffer, sizeof(buffer));
+    write_multiples(&out, numbers, count);
+    writer_flush(&out);
+}
+
+void print_prime_info(uint64_t x, bool is_prime_flag) {
+    char buffer[PRINT_BUFFER_SIZE];
+    writer_t out;
+    writer_init(&out, stdout, buffer, sizeof(buffer));
+    write_prime_info(&out, x, is_prime_flag);
+    writer_flush(&out);
+}
+
+void print_digits(const char *digits, int count) {
+    char buffer[PRINT_BUFFER_SIZE];
+    writer_t out;
+    writer_init(&out, stdout, buffer, sizeof(buffer));
+    write_digits(&out, digits, count);
+    writer_flush(&out);
 }
 
 void print_power_table(long long **table, int max_power) {
-    printf("Power table (numbers 1-10):\n");
-    printf("Base | Powers\n");
-    
-    for (int i = 0; i < 10; i++) {
-        printf("%4d | ", i + 1);
-        for (int j = 0; j < max_power; j++) {
-            printf("%lld ", table[i][j]);
-        }
-        printf("\n");
+    char buffer[PRINT_BUFFER_SIZE];
+    writer_t out;
+    writer_init(&out, stdout, buffer, sizeof(buffer));
+    writer_puts(&out, "Power table (numbers 1-10):\nBase | Powers\n");
+    for (int i = 0; i < POWER_TABLE_BASES; i++) {
+        write_power_row(&out, i + 1, table[i], max_power);
     }
+    writer_flush(&out);
+}
+
+void print_power_table_flat(const long long *table, int max_power) {
+    char buffer[PRINT_BUFFER_SIZE];
+    writer_t out;
+    writer_init(&out, stdout, buffer, sizeof(buffer));
+    write_power_table_flat(&out, table, max_power);
+    writer_flush(&out);
 }
 
 void print_sum(long long sum) {
-    printf("Sum of numbers from 1 to N: %lld\n", sum);
+    char buffer[PRINT_BUFFER_SIZE];
+    writer_t out;
+    writer_init(&out, stdout, buffer, sizeof(buffer));
+    write_sum(&out, sum);
+    writer_flush(&out);
 }
 
 void print_factorial(long long factorial) {
-    printf("Factorial: %lld\n", factorial);
-}
\ No newline at end of file
+    char buffer[PRINT_BUFFER_SIZE];
+    writer_t out;
+    writer_init(&out, stdout, buffer, sizeof(buffer));
+    write_factorial(&out, factorial);
+    writer_flush(&out);
+}
+
+void print_exact_factorial(const bignum_t *factorial) {
+    char buffer[PRINT_BUFFER_SIZE];
+    writer_t out;
+    writer_init(&out, stdout, buffer, sizeof(buffer));
+    write_exact_factorial(&out, factorial);
+    writer_flush(&out);
+}
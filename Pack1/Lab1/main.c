@@ -6,104 +6,281 @@
 #include <errno.h>
 #include <limits.h>
 
+#define OUTPUT_BUFFER_SIZE (1 << 16)
+#define INPUT_BUFFER_SIZE (1 << 16)
+#define FLAG_LIST "-h, -p, -s, -e, -a, -f"
 
-int main(int argc, char *argv[])
-{
-    if (argc != 3) {
-        printf("Usage: %s <number> <flag>\n", argv[0]);
-        printf("Available flags: -h, -p, -s, -e, -a, -f\n");
-        return ERROR_INVALID_INPUT;
+typedef int (*flag_handler_t)(unsigned long long x, writer_t *out);
+
+typedef struct {
+    flag_handler_t handler;
+    unsigned long long max_value;
+} flag_entry_t;
+
+static char output_buffer[OUTPUT_BUFFER_SIZE];
+static char input_buffer[INPUT_BUFFER_SIZE];
+
+static int run_h(unsigned long long x, writer_t *out) {
+    int multiples[MULTIPLES_LIMIT];
+    int count = 0;
+
+    int status = flag_h_into((int)x, multiples, MULTIPLES_LIMIT, &count);
+    if (status == SUCCESS) {
+        write_multiples(out, multiples, count);
+    } else {
+        writer_puts(out, "No multiples found or invalid input\n");
+    }
+    return status;
+}
+
+static int run_p(unsigned long long x, writer_t *out) {
+    write_prime_info(out, (uint64_t)x, flag_p((uint64_t)x));
+    return SUCCESS;
+}
+
+static int run_s(unsigned long long x, writer_t *out) {
+    char digits[DIGITS_BUFFER_SIZE];
+    int length = 0;
+
+    int status = flag_s_into((int)x, digits, DIGITS_BUFFER_SIZE, &length);
+    if (status == SUCCESS) {
+        write_digits(out, digits, length);
     }
+    return status;
+}
+
+static int run_e(unsigned long long x, writer_t *out) {
+    long long table[POWER_TABLE_BASES * POWER_TABLE_MAX_POWER];
 
-    char *endptr;
-    errno = 0;
-    long x_long = strtol(argv[1], &endptr, 10);
-    
-    if (errno == ERANGE || x_long > INT_MAX || x_long < INT_MIN) {
-        printf("Error: Number out of range\n");
+    int status = flag_e_into((int)x, table, POWER_TABLE_BASES * POWER_TABLE_MAX_POWER);
+    if (status == SUCCESS) {
+        write_power_table_flat(out, table, (int)x);
+    }
+    return status;
+}
+
+static int run_a(unsigned long long x, writer_t *out) {
+    long long sum = 0;
+
+    int status = flag_a((int)x, &sum);
+    if (status == SUCCESS) {
+        write_sum(out, sum);
+    }
+    return status;
+}
+
+static int run_f(unsigned long long x, writer_t *out) {
+    bignum_t factorial;
+
+    int status = flag_f_exact((int)x, &factorial);
+    if (status == SUCCESS) {
+        status = write_exact_factorial(out, &factorial);
+        bignum_free(&factorial);
+    } else {
+        writer_puts(out, "Error: Cannot calculate factorial for number ");
+        writer_uint(out, x);
+        writer_char(out, '\n');
+    }
+    return status;
+}
+
+static const flag_entry_t flag_table[128] = {
+    ['h'] = { run_h, INT_MAX },
+    ['p'] = { run_p, ULLONG_MAX },
+    ['s'] = { run_s, INT_MAX },
+    ['e'] = { run_e, INT_MAX },
+    ['a'] = { run_a, INT_MAX },
+    ['f'] = { run_f, INT_MAX }
+};
+
+static const flag_entry_t *find_flag(const char *flag) {
+    if ((flag[0] != '-' && flag[0] != '/') || flag[1] == '\0' || flag[2] != '\0') {
+        return NULL;
+    }
+
+    unsigned char name = (unsigned char)flag[1];
+    if (name >= 128 || flag_table[name].handler == NULL) {
+        return NULL;
+    }
+    return &flag_table[name];
+}
+
+static int parse_number(const char *text, unsigned long long max_value, unsigned long long *value, writer_t *out) {
+    const char *digits = text[0] == '-' || text[0] == '+' ? text + 1 : text;
+    unsigned long long result = 0;
+    bool overflow = false;
+
+    const char *c = digits;
+    bool negative = text[0] == '-';
+
+    /* Like strtol: the leading digits are range-checked first, then trailing characters, then the sign. */
+    if (negative) {
+        max_value = (unsigned long long)INT_MAX + 1;
+    }
+
+    for (; isdigit((unsigned char)*c); c++) {
+        unsigned digit = (unsigned)(*c - '0');
+        if (result > (max_value - digit) / 10) {
+            overflow = true;
+        } else {
+            result = result * 10 + digit;
+        }
+    }
+
+    if (overflow) {
+        writer_puts(out, "Error: Number out of range\n");
         return ERROR_OUT_OF_RANGE;
     }
-    
-    if (*endptr != '\0') {
-        printf("Error: First argument must be a valid integer\n");
+
+    if (c == digits || *c != '\0') {
+        writer_puts(out, "Error: First argument must be a valid integer\n");
+        return ERROR_INVALID_INPUT;
+    }
+
+    if (negative && result != 0) {
+        writer_puts(out, "Error: Number must be non-negative\n");
         return ERROR_INVALID_INPUT;
     }
-    
-    int x = (int)x_long;
-    
-    if (x < 0) {
-        printf("Error: Number must be non-negative\n");
+
+    *value = result;
+    return SUCCESS;
+}
+
+static int run_record(const char *number, const char *flag, writer_t *out) {
+    const flag_entry_t *entry = find_flag(flag);
+    unsigned long long x;
+
+    int status = parse_number(number, entry != NULL ? entry->max_value : INT_MAX, &x, out);
+    if (status != SUCCESS) {
+        return status;
+    }
+
+    if (entry == NULL) {
+        writer_puts(out, "Error: Invalid flag. Available flags: " FLAG_LIST "\n");
         return ERROR_INVALID_INPUT;
     }
 
-    char *flag = argv[2];
-    StatusCode status = SUCCESS;
+    return entry->handler(x, out);
+}
 
-    if (strcmp(flag, "-h") == 0 || strcmp(flag, "/h") == 0) {
-        int *multiples = NULL;
-        int count = 0;
-        
-        status = flag_h(x, &multiples, &count);
-        if (status == SUCCESS) {
-            print_multiples(multiples, count);
-            free(multiples);
-        } else {
-            printf("No multiples found or invalid input\n");
-        }
-        
-    } else if (strcmp(flag, "-p") == 0 || strcmp(flag, "/p") == 0) {
-        bool prime = flag_p(x);
-        print_prime_info(x, prime);
-        
-    } else if (strcmp(flag, "-s") == 0 || strcmp(flag, "/s") == 0) {
-        char *digits = NULL;
-        
-        status = flag_s(x, &digits);
-        if (status == SUCCESS) {
-            int temp = x;
-            int length = 0;
-            do {
-                length++;
-                temp /= 10;
-            } while (temp > 0);
-            
-            print_digits(digits, length);
-            free(digits);
-        }
-        
-    } else if (strcmp(flag, "-e") == 0 || strcmp(flag, "/e") == 0) {
-        long long **table = NULL;
-        
-        status = flag_e(x, &table);
-        if (status == SUCCESS) {
-            print_power_table(table, x);
-            for (int i = 0; i < 10; i++) {
-                free(table[i]);
+static int run_line(char *line, writer_t *out) {
+    char *tokens[3];
+    int count = 0;
+
+    for (char *c = line; *c != '\0' && count < 3; ) {
+        while (isspace((unsigned char)*c)) *c++ = '\0';
+        if (*c == '\0') break;
+        tokens[count++] = c;
+        while (*c != '\0' && !isspace((unsigned char)*c)) c++;
+    }
+
+    if (count == 0) {
+        return SUCCESS;
+    }
+
+    if (count != 2) {
+        writer_puts(out, "Error: Expected <number> <flag>\n");
+        return ERROR_INVALID_INPUT;
+    }
+
+    return run_record(tokens[0], tokens[1], out);
+}
+
+/*
+ * Reads newline-separated "<number> <flag>" records; errors are reported per record.
+ * Returns the status of the first failed record, or SUCCESS if every record succeeded.
+ */
+static int run_batch(FILE *input, writer_t *out) {
+    size_t start = 0;
+    size_t end = 0;
+    bool eof = false;
+    bool skipping = false;
+    int status = SUCCESS;
+
+    while (true) {
+        char *newline = memchr(input_buffer + start, '\n', end - start);
+
+        if (skipping) {
+            if (newline == NULL) {
+                start = end;
+            } else {
+                start = (size_t)(newline - input_buffer) + 1;
+                skipping = false;
+                continue;
             }
-            free(table);
+        } else if (newline != NULL) {
+            *newline = '\0';
+            int record = run_line(input_buffer + start, out);
+            if (status == SUCCESS) status = record;
+            start = (size_t)(newline - input_buffer) + 1;
+            continue;
         }
-        
-    } else if (strcmp(flag, "-a") == 0 || strcmp(flag, "/a") == 0) {
-        long long sum = 0;
-        
-        status = flag_a(x, &sum);
-        if (status == SUCCESS) {
-            print_sum(sum);
+
+        if (eof) {
+            if (end > start) {
+                input_buffer[end] = '\0';
+                int record = run_line(input_buffer + start, out);
+                if (status == SUCCESS) status = record;
+            }
+            break;
         }
-        
-    } else if (strcmp(flag, "-f") == 0 || strcmp(flag, "/f") == 0) {
-        long long factorial = flag_f(x);
-        if (factorial > 0) {
-            print_factorial(factorial);
+
+        if (start == 0 && end == INPUT_BUFFER_SIZE - 1) {
+            writer_puts(out, "Error: Record too long\n");
+            if (status == SUCCESS) status = ERROR_INVALID_INPUT;
+            skipping = true;
+            end = 0;
         } else {
-            printf("Error: Cannot calculate factorial for number %d\n", x);
-            status = ERROR_NUMBER_TOO_LARGE;
+            memmove(input_buffer, input_buffer + start, end - start);
+            end -= start;
         }
-        
-    } else {
-        printf("Error: Invalid flag. Available flags: -h, -p, -s, -e, -a, -f\n");
+        start = 0;
+
+        size_t read = fread(input_buffer + end, 1, INPUT_BUFFER_SIZE - 1 - end, input);
+        end += read;
+        eof = read == 0;
+    }
+
+    return ferror(input) ? ERROR_INVALID_INPUT : status;
+}
+
+int main(int argc, char *argv[])
+{
+    writer_t out;
+    writer_init(&out, stdout, output_buffer, OUTPUT_BUFFER_SIZE);
+
+    if (argc == 2 && strcmp(argv[1], "--check") == 0) {
+        int status = power_table_check();
+        printf(status == SUCCESS ? "Power table: OK\n" : "Power table: mismatch\n");
+        return status;
+    }
+
+    if ((argc == 2 || argc == 3) && strcmp(argv[1], "--batch") == 0) {
+        FILE *input = stdin;
+
+        if (argc == 3 && strcmp(argv[2], "-") != 0) {
+            input = fopen(argv[2], "r");
+            if (input == NULL) {
+                printf("Error: Cannot open %s\n", argv[2]);
+                return ERROR_INVALID_INPUT;
+            }
+        }
+
+        int status = run_batch(input, &out);
+        writer_flush(&out);
+        if (input != stdin) fclose(input);
+        return status;
+    }
+
+    if (argc != 3) {
+        printf("Usage: %s <number> <flag>\n", argv[0]);
+        printf("       %s --batch [file]\n", argv[0]);
+        printf("       %s --check\n", argv[0]);
+        printf("Available flags: " FLAG_LIST "\n");
         return ERROR_INVALID_INPUT;
     }
 
+    int status = run_record(argv[1], argv[2], &out);
+    writer_flush(&out);
     return status;
-}
\ No newline at end of file
+}
@@ -0,0 +1,111 @@
+#include "writer.h"
+#include <string.h>
+
+#define WRITER_NUMBER_SIZE 20
+
+static const uint64_t powers_of_ten[WRITER_NUMBER_SIZE] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/* bits * 1233 / 4096 approximates bits * log10(2) from below; one compare fixes it up. */
+size_t decimal_length(uint64_t value) {
+    uint64_t nonzero = value | 1;
+    unsigned estimate = (unsigned)((64 - __builtin_clzll(nonzero)) * 1233) >> 12;
+    return estimate + (nonzero >= powers_of_ten[estimate]);
+}
+
+size_t format_decimal(uint64_t value, char *out) {
+    size_t length = decimal_length(value);
+    char *end = out + length;
+
+    while (value >= 100) {
+        unsigned pair = (unsigned)(value % 100) * 2;
+        value /= 100;
+        end -= 2;
+        end[0] = digit_pairs[pair];
+        end[1] = digit_pairs[pair + 1];
+    }
+    if (value >= 10) {
+        end -= 2;
+        end[0] = digit_pairs[value * 2];
+        end[1] = digit_pairs[value * 2 + 1];
+    } else {
+        end[-1] = (char)('0' + value);
+    }
+
+    return length;
+}
+
+void writer_init(writer_t *writer, FILE *stream, char *buffer, size_t capacity) {
+    writer->stream = stream;
+    writer->buffer = buffer;
+    writer->capacity = capacity;
+    writer->used = 0;
+}
+
+int writer_flush(writer_t *writer) {
+    if (writer->used > 0 && fwrite(writer->buffer, 1, writer->used, writer->stream) != writer->used) {
+        writer->used = 0;
+        return -1;
+    }
+    writer->used = 0;
+    return fflush(writer->stream);
+}
+
+void writer_write(writer_t *writer, const char *data, size_t length) {
+    if (length > writer->capacity - writer->used) {
+        if (writer->used > 0) {
+            fwrite(writer->buffer, 1, writer->used, writer->stream);
+            writer->used = 0;
+        }
+        if (length > writer->capacity) {
+            fwrite(data, 1, length, writer->stream);
+            return;
+        }
+    }
+
+    memcpy(writer->buffer + writer->used, data, length);
+    writer->used += length;
+}
+
+void writer_puts(writer_t *writer, const char *text) {
+    writer_write(writer, text, strlen(text));
+}
+
+void writer_char(writer_t *writer, char c) {
+    if (writer->used == writer->capacity) {
+        fwrite(writer->buffer, 1, writer->used, writer->stream);
+        writer->used = 0;
+    }
+    writer->buffer[writer->used++] = c;
+}
+
+void writer_uint(writer_t *writer, unsigned long long value) {
+    if (writer->capacity < WRITER_NUMBER_SIZE) {
+        char digits[WRITER_NUMBER_SIZE];
+        writer_write(writer, digits, format_decimal(value, digits));
+        return;
+    }
+    if (writer->capacity - writer->used < WRITER_NUMBER_SIZE) {
+        fwrite(writer->buffer, 1, writer->used, writer->stream);
+        writer->used = 0;
+    }
+    writer->used += format_decimal(value, writer->buffer + writer->used);
+}
+
+void writer_int(writer_t *writer, long long value) {
+    if (value < 0) {
+        writer_char(writer, '-');
+        writer_uint(writer, 0ULL - (unsigned long long)value);
+    } else {
+        writer_uint(writer, (unsigned long long)value);
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    FILE *stream;
+    char *buffer;
+    size_t capacity;
+    size_t used;
+} writer_t;
+
+size_t decimal_length(uint64_t value);
+size_t format_decimal(uint64_t value, char *out);
+
+void writer_init(writer_t *writer, FILE *stream, char *buffer, size_t capacity);
+int writer_flush(writer_t *writer);
+void writer_write(writer_t *writer, const char *data, size_t length);
+void writer_puts(writer_t *writer, const char *text);
+void writer_char(writer_t *writer, char c);
+void writer_uint(writer_t *writer, unsigned long long value);
+void writer_int(writer_t *writer, long long value);
+
+#endif
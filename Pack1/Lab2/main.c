@@ -1,25 +1,69 @@
 #include "prime.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
 
-int main(void) {
+static int build_table(const char* path, const char* limit_text) {
+    char* endptr;
+    unsigned long long limit = strtoull(limit_text, &endptr, 10);
+    
+    if (*endptr != '\0' || limit < 3) {
+        printf("Error: table limit must be an integer of at least 3\n");
+        return 1;
+    }
+    
+    if (prime_table_build(path, (uint64_t)limit, PRIME_TABLE_BLOCK_SIZE) != SUCCESS) {
+        printf("Error: cannot build prime table %s\n", path);
+        return 1;
+    }
+    
+    printf("Prime table written to %s\n", path);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 4 && strcmp(argv[1], "--build-table") == 0) {
+        return build_table(argv[2], argv[3]);
+    }
+    
+    if (argc > 2) {
+        printf("Usage: %s [prime_table]\n", argv[0]);
+        printf("       %s --build-table <prime_table> <limit>\n", argv[0]);
+        return 1;
+    }
+    
+    prime_table_t table;
+    bool use_table = false;
+    
+    if (argc == 2) {
+        if (prime_table_open(argv[1], &table) != SUCCESS) {
+            printf("Error: cannot open prime table %s\n", argv[1]);
+            return 1;
+        }
+        use_table = true;
+    }
+    
     int t;
     
     printf("Enter the number of requests: ");
     
     if (scanf("%d", &t) != 1) {
         printf("Input error: cannot read number of requests\n");
+        if (use_table) prime_table_close(&table);
         return 1;
     }
     
     if (t <= 0) {
         printf("Error: number of requests must be positive\n");
+        if (use_table) prime_table_close(&table);
         return 1;
     }
     
     int* numbers = (int*)malloc((size_t)t * sizeof(int));
     if (!numbers) {
         printf("Memory allocation error\n");
+        if (use_table) prime_table_close(&table);
         return 1;
     }
     
@@ -29,6 +73,7 @@ int main(void) {
         if (scanf("%d", &numbers[i]) != 1) {
             printf("Input error at request %d\n", i + 1);
             free(numbers);
+            if (use_table) prime_table_close(&table);
             return 1;
         }
     }
@@ -38,31 +83,55 @@ int main(void) {
     if (validation_status != SUCCESS) {
         printf("Incorrect input data\n");
         free(numbers);
+        if (use_table) prime_table_close(&table);
         return 1;
     }
     
+    uint32_t* ordinals = (uint32_t*)malloc((size_t)t * sizeof(uint32_t));
+    int* positions = (int*)malloc((size_t)t * sizeof(int));
+    uint64_t* computed = (uint64_t*)malloc((size_t)t * sizeof(uint64_t));
     uint64_t* results = (uint64_t*)malloc((size_t)t * sizeof(uint64_t));
     status_t* statuses = (status_t*)malloc((size_t)t * sizeof(status_t));
     
-    if (!results || !statuses) {
+    if (!ordinals || !positions || !computed || !results || !statuses) {
         printf("Memory allocation error\n");
         free(numbers);
+        if (ordinals) free(ordinals);
+        if (positions) free(positions);
+        if (computed) free(computed);
         if (results) free(results);
         if (statuses) free(statuses);
+        if (use_table) prime_table_close(&table);
         return 1;
     }
     
     printf("Output:\n");
     
+    size_t pending = 0;
     for (int i = 0; i < t; i++) {
-        statuses[i] = find_nth_prime((uint32_t)numbers[i], &results[i]);
+        statuses[i] = use_table ? prime_table_nth(&table, (uint32_t)numbers[i], &results[i]) : OUT_OF_RANGE;
+        if (statuses[i] == OUT_OF_RANGE) {
+            positions[pending] = i;
+            ordinals[pending] = (uint32_t)numbers[i];
+            pending++;
+        }
+    }
+    
+    status_t batch_status = find_nth_primes(ordinals, pending, computed);
+    for (size_t k = 0; k < pending; k++) {
+        results[positions[k]] = computed[k];
+        statuses[positions[k]] = batch_status;
     }
     
     print_results(results, numbers, t, statuses);
     
     free(numbers);
+    free(ordinals);
+    free(positions);
+    free(computed);
     free(results);
     free(statuses);
+    if (use_table) prime_table_close(&table);
     
     return 0;
-}
\ No newline at end of file
+}
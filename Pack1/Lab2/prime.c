@@ -1,60 +1,658 @@
 #include "prime.h"
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include <stdio.h>
 #include <math.h>
+#include <pthread.h>
 
-static status_t sieve_of_eratosthenes(uint64_t limit, uint64_t** primes_ptr, uint32_t* count_ptr) {
-    if (limit < 2) {
-        *count_ptr = 0;
-        *primes_ptr = NULL;
-        return SUCCESS;
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Segments use a mod 30 wheel: byte b covers the 30 integers starting at 30 * b and its
+ * eight bits stand for the residues coprime to 30. A set bit marks a composite.
+ */
+#define WHEEL_SIZE 30u
+#define SEGMENT_BYTES 32768u
+#define SEGMENT_SPAN ((uint64_t)SEGMENT_BYTES * WHEEL_SIZE)
+#define PRESIEVE_PERIOD 17017u
+#define FIRST_SIEVING_PRIME 19u
+#define COUNTING_THRESHOLD 100000u
+#define COUNTING_COST_FACTOR 1.5
+
+static const uint8_t wheel_residues[8] = { 1, 7, 11, 13, 17, 19, 23, 29 };
+static const uint8_t wheel_bits[WHEEL_SIZE] = {
+    0, 1 << 0, 0, 0, 0, 0, 0, 1 << 1, 0, 0, 0, 1 << 2, 0, 1 << 3, 0,
+    0, 0, 1 << 4, 0, 1 << 5, 0, 0, 0, 1 << 6, 0, 0, 0, 0, 0, 1 << 7
+};
+static const uint8_t small_primes[3] = { 2, 3, 5 };
+
+/* Multiples of 7, 11, 13 and 17 over one period of 7 * 11 * 13 * 17 wheel bytes. */
+static uint8_t presieve_pattern[PRESIEVE_PERIOD];
+static pthread_once_t presieve_once = PTHREAD_ONCE_INIT;
+
+static void build_presieve_pattern(void) {
+    static const uint32_t presieve_primes[4] = { 7, 11, 13, 17 };
+
+    for (uint32_t b = 0; b < PRESIEVE_PERIOD; b++) {
+        uint8_t bits = 0;
+        for (int i = 0; i < 8; i++) {
+            uint32_t value = WHEEL_SIZE * b + wheel_residues[i];
+            for (int k = 0; k < 4; k++) {
+                if (value % presieve_primes[k] == 0) {
+                    bits |= (uint8_t)(1u << i);
+                }
+            }
+        }
+        presieve_pattern[b] = bits;
     }
+}
 
-    bool* is_prime = (bool*)calloc(limit + 1, sizeof(bool));
-    if (!is_prime) {
-        return MEMORY_ERROR;
+static uint64_t isqrt64(uint64_t x) {
+    uint64_t r = (uint64_t)sqrt((double)x);
+    while (r > 0 && r * r > x) {
+        r--;
+    }
+    while ((r + 1) * (r + 1) <= x) {
+        r++;
     }
+    return r;
+}
 
-    for (uint64_t i = 2; i <= limit; i++) {
-        is_prime[i] = true;
+/* Odd primes up to limit, found with an odd-only bitset (bit i stands for 2i + 3). */
+static status_t collect_sieving_primes(uint32_t limit, uint32_t** primes_ptr, uint32_t* count_ptr) {
+    *primes_ptr = NULL;
+    *count_ptr = 0;
+    if (limit < 3) {
+        return SUCCESS;
     }
 
-    for (uint64_t i = 2; i * i <= limit; i++) {
-        if (is_prime[i]) {
-            for (uint64_t j = i * i; j <= limit; j += i) {
-                is_prime[j] = false;
+    uint32_t bits = (limit - 1) / 2;
+    uint8_t* composite = (uint8_t*)calloc(bits / 8 + 1, 1);
+    if (!composite) {
+        return MEMORY_ERROR;
+    }
+
+    for (uint32_t i = 0; i < bits; i++) {
+        uint64_t p = 2 * (uint64_t)i + 3;
+        if (p * p > limit) {
+            break;
+        }
+        if (!(composite[i >> 3] & (1u << (i & 7)))) {
+            for (uint64_t j = (p * p - 3) / 2; j < bits; j += p) {
+                composite[j >> 3] |= (uint8_t)(1u << (j & 7));
             }
         }
     }
 
     uint32_t prime_count = 0;
-    for (uint64_t i = 2; i <= limit; i++) {
-        if (is_prime[i]) {
+    for (uint32_t i = 0; i < bits; i++) {
+        if (!(composite[i >> 3] & (1u << (i & 7)))) {
             prime_count++;
         }
     }
 
-    uint64_t* primes = (uint64_t*)malloc(prime_count * sizeof(uint64_t));
+    uint32_t* primes = (uint32_t*)malloc((prime_count + 1) * sizeof(uint32_t));
     if (!primes) {
-        free(is_prime);
+        free(composite);
         return MEMORY_ERROR;
     }
 
     uint32_t index = 0;
-    for (uint64_t i = 2; i <= limit; i++) {
-        if (is_prime[i]) {
-            primes[index++] = i;
+    for (uint32_t i = 0; i < bits; i++) {
+        if (!(composite[i >> 3] & (1u << (i & 7)))) {
+            primes[index++] = 2 * i + 3;
         }
     }
 
-    free(is_prime);
+    free(composite);
     *primes_ptr = primes;
     *count_ptr = prime_count;
-    
+
     return SUCCESS;
 }
 
+/* Number of wheel bytes in the segment starting at first_byte that hold values up to limit. */
+static uint32_t segment_length(uint64_t first_byte, uint64_t limit) {
+    uint64_t remaining = limit / WHEEL_SIZE - first_byte + 1;
+    return remaining < SEGMENT_BYTES ? (uint32_t)remaining : SEGMENT_BYTES;
+}
+
+/* Strikes p * q for every q >= p coprime to 30 that falls into the segment. */
+static void strike_prime(uint8_t* bytes, uint64_t first_byte, uint32_t byte_count, uint32_t p) {
+    uint32_t a = p / WHEEL_SIZE;
+    uint32_t r = p % WHEEL_SIZE;
+    int64_t offsets[8];
+    uint8_t masks[8];
+    int first_residue = 0;
+
+    /* p * (30k + R[j]) lies in byte k * p + offsets[j] at the bit of (r * R[j]) mod 30. */
+    for (int j = 0; j < 8; j++) {
+        uint32_t product = r * wheel_residues[j];
+        offsets[j] = (int64_t)a * wheel_residues[j] + product / WHEEL_SIZE;
+        masks[j] = wheel_bits[product % WHEEL_SIZE];
+        if (wheel_residues[j] < r) {
+            first_residue = j + 1;
+        }
+    }
+
+    uint64_t cycle = first_byte / p;
+    if (cycle <= a) {
+        cycle = a;
+    } else {
+        first_residue = 0;
+    }
+
+    int64_t length = byte_count;
+    int64_t base = (int64_t)(cycle * p) - (int64_t)first_byte;
+
+    for (int j = first_residue; j < 8; j++) {
+        int64_t b = base + offsets[j];
+        if (b >= 0 && b < length) {
+            bytes[b] |= masks[j];
+        }
+    }
+    base += p;
+
+    for (; base + p <= length; base += p) {
+        for (int j = 0; j < 8; j++) {
+            bytes[base + offsets[j]] |= masks[j];
+        }
+    }
+
+    for (int j = 0; j < 8; j++) {
+        int64_t b = base + offsets[j];
+        if (b < length) {
+            bytes[b] |= masks[j];
+        }
+    }
+}
+
+/*
+ * Sieves the wheel bytes [first_byte, first_byte + byte_count) and marks every value above
+ * limit. The segment starts as a copy of the pre-sieved pattern, so only primes from 19 up
+ * are struck; bytes past byte_count are filled so that they never count as primes.
+ */
+static void sieve_segment(uint8_t* bytes, uint64_t first_byte, uint32_t byte_count, uint64_t limit,
+                          const uint32_t* primes, uint32_t prime_count) {
+    pthread_once(&presieve_once, build_presieve_pattern);
+
+    uint32_t offset = (uint32_t)(first_byte % PRESIEVE_PERIOD);
+    for (uint32_t filled = 0; filled < byte_count; ) {
+        uint32_t chunk = PRESIEVE_PERIOD - offset;
+        if (chunk > byte_count - filled) {
+            chunk = byte_count - filled;
+        }
+        memcpy(bytes + filled, presieve_pattern + offset, chunk);
+        filled += chunk;
+        offset = 0;
+    }
+    memset(bytes + byte_count, 0xFF, SEGMENT_BYTES - byte_count);
+
+    if (first_byte == 0) {
+        bytes[0] = (uint8_t)((bytes[0] & ~0x1Eu) | 0x01u);
+    }
+
+    uint64_t last_byte = first_byte + byte_count - 1;
+    if (last_byte == limit / WHEEL_SIZE) {
+        for (int i = 0; i < 8; i++) {
+            if (WHEEL_SIZE * last_byte + wheel_residues[i] > limit) {
+                bytes[byte_count - 1] |= (uint8_t)(1u << i);
+            }
+        }
+    }
+
+    uint64_t end_value = WHEEL_SIZE * (first_byte + byte_count);
+    for (uint32_t k = 0; k < prime_count; k++) {
+        uint64_t p = primes[k];
+        if (p < FIRST_SIEVING_PRIME) {
+            continue;
+        }
+        if (p * p >= end_value) {
+            break;
+        }
+        strike_prime(bytes, first_byte, byte_count, (uint32_t)p);
+    }
+}
+
+static uint64_t load_word(const uint8_t* bytes) {
+    uint64_t word;
+    memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+static uint32_t count_segment(const uint8_t* bytes) {
+    uint32_t count = 0;
+    for (uint32_t b = 0; b < SEGMENT_BYTES; b += 8) {
+        count += (uint32_t)__builtin_popcountll(~load_word(bytes + b));
+    }
+    return count;
+}
+
+/*
+ * Offset from the segment start of the k-th (0-based) prime at or after *position, where
+ * *before primes precede *position. Both are advanced, so increasing k values can be
+ * selected in one pass over the segment.
+ */
+static uint32_t select_from(const uint8_t* bytes, uint32_t* position, uint32_t* before, uint32_t k) {
+    uint32_t b = *position;
+    uint32_t seen = *before;
+
+    while (1) {
+        if ((b & 7) == 0) {
+            uint32_t in_word = (uint32_t)__builtin_popcountll(~load_word(bytes + b));
+            if (seen + in_word <= k) {
+                seen += in_word;
+                b += 8;
+                continue;
+            }
+        }
+        uint32_t in_byte = (uint32_t)__builtin_popcount((uint8_t)~bytes[b]);
+        if (seen + in_byte <= k) {
+            seen += in_byte;
+            b++;
+            continue;
+        }
+        break;
+    }
+
+    *position = b;
+    *before = seen;
+
+    uint32_t candidates = (uint8_t)~bytes[b];
+    for (uint32_t skip = k - seen; skip > 0; skip--) {
+        candidates &= candidates - 1;
+    }
+    return WHEEL_SIZE * b + wheel_residues[__builtin_ctz(candidates)];
+}
+
+/* Offset of the k-th (0-based) prime in a sieved segment; k must be below count_segment. */
+static uint32_t select_in_segment(const uint8_t* bytes, uint32_t k) {
+    uint32_t position = 0;
+    uint32_t before = 0;
+    return select_from(bytes, &position, &before, k);
+}
+
+/*
+ * Incremental segmented sieve over [0, limit]. The current segment starts at wheel byte
+ * first and holds found primes, with before primes above 5 in the bytes below it. Raising
+ * the limit keeps that count and only re-sieves the segment that the old limit cut short.
+ */
+typedef struct {
+    uint64_t limit;
+    uint32_t* primes;
+    uint32_t prime_count;
+    uint8_t* segment;
+    uint64_t first;
+    uint32_t length;
+    uint32_t found;
+    uint64_t before;
+} prime_sweep_t;
+
+static status_t sweep_init(prime_sweep_t* sweep, uint64_t limit) {
+    memset(sweep, 0, sizeof(*sweep));
+    sweep->limit = limit;
+
+    sweep->segment = (uint8_t*)malloc(SEGMENT_BYTES);
+    if (!sweep->segment) {
+        return MEMORY_ERROR;
+    }
+
+    status_t status = collect_sieving_primes((uint32_t)isqrt64(limit), &sweep->primes, &sweep->prime_count);
+    if (status != SUCCESS) {
+        free(sweep->segment);
+        sweep->segment = NULL;
+    }
+    return status;
+}
+
+static void sweep_free(prime_sweep_t* sweep) {
+    free(sweep->primes);
+    free(sweep->segment);
+    sweep->primes = NULL;
+    sweep->segment = NULL;
+}
+
+static status_t sweep_extend(prime_sweep_t* sweep, uint64_t limit) {
+    uint32_t* primes = NULL;
+    uint32_t prime_count = 0;
+    status_t status = collect_sieving_primes((uint32_t)isqrt64(limit), &primes, &prime_count);
+    if (status != SUCCESS) {
+        return status;
+    }
+
+    free(sweep->primes);
+    sweep->primes = primes;
+    sweep->prime_count = prime_count;
+    sweep->limit = limit;
+    sweep->length = 0;
+    sweep->found = 0;
+
+    return SUCCESS;
+}
+
+/* Sieves the segment after the current one; false once the limit has been reached. */
+static bool sweep_next(prime_sweep_t* sweep) {
+    uint64_t next = sweep->first + sweep->length;
+    if (next > sweep->limit / WHEEL_SIZE) {
+        return false;
+    }
+
+    sweep->before += sweep->found;
+    sweep->first = next;
+    sweep->length = segment_length(next, sweep->limit);
+    sieve_segment(sweep->segment, next, sweep->length, sweep->limit, sweep->primes, sweep->prime_count);
+    sweep->found = count_segment(sweep->segment);
+
+    return true;
+}
+
+/*
+ * pi(x) by the Lucy_Hedgehog recurrence. small[v] holds the running count for v <= sqrt(x)
+ * and large[i] the count for x / i; each sieving prime p removes its contribution from the
+ * values >= p^2, giving O(x^(3/4)) time in O(sqrt(x)) memory.
+ */
+status_t count_primes(uint64_t x, uint64_t* result) {
+    if (result == NULL) {
+        return INVALID_INPUT;
+    }
+
+    if (x < 2) {
+        *result = 0;
+        return SUCCESS;
+    }
+
+    uint64_t root = isqrt64(x);
+    uint64_t* small = (uint64_t*)malloc((root + 1) * sizeof(uint64_t));
+    uint64_t* large = (uint64_t*)malloc((root + 1) * sizeof(uint64_t));
+    if (!small || !large) {
+        free(small);
+        free(large);
+        return MEMORY_ERROR;
+    }
+
+    small[0] = 0;
+    for (uint64_t v = 1; v <= root; v++) {
+        small[v] = v - 1;
+        large[v] = x / v - 1;
+    }
+
+    for (uint64_t p = 2; p <= root; p++) {
+        if (small[p] == small[p - 1]) {
+            continue;
+        }
+
+        uint64_t below = small[p - 1];
+        uint64_t square = p * p;
+        uint64_t i_end = x / square < root ? x / square : root;
+
+        for (uint64_t i = 1; i <= i_end; i++) {
+            uint64_t d = i * p;
+            large[i] -= (d <= root ? large[d] : small[x / d]) - below;
+        }
+        for (uint64_t v = root; v >= square; v--) {
+            small[v] -= small[v / p] - below;
+        }
+    }
+
+    *result = large[1];
+    free(small);
+    free(large);
+
+    return SUCCESS;
+}
+
+/* Ramanujan's series for li(x). */
+static double logarithmic_integral(double x) {
+    const double euler_gamma = 0.57721566490153286061;
+    double log_x = log(x);
+    double factor = -2.0;
+    double inner = 0.0;
+    double sum = 0.0;
+
+    for (int k = 1; k < 200; k++) {
+        factor *= -log_x / (2.0 * k);
+        if (k & 1) {
+            inner += 1.0 / k;
+        }
+        double term = factor * inner;
+        sum += term;
+        if (fabs(term) < 1e-17 * fabs(sum)) {
+            break;
+        }
+    }
+
+    return euler_gamma + log(log_x) + sqrt(x) * sum;
+}
+
+/* li^-1(n) by Newton's method; within about sqrt(p_n) * ln(p_n) of the n-th prime. */
+static uint64_t inverse_logarithmic_integral(uint32_t n) {
+    double x = n * log((double)n);
+    for (int i = 0; i < 32; i++) {
+        double step = (logarithmic_integral(x) - n) * log(x);
+        x -= step;
+        if (fabs(step) < 0.5) {
+            break;
+        }
+    }
+    return (uint64_t)x;
+}
+
+/*
+ * Finds the n-th prime for large n: pi is evaluated at li^-1(n), then a segmented sieve
+ * walks up or down from that point until the remaining difference has been counted.
+ */
+static status_t find_nth_prime_by_counting(uint32_t n, uint8_t* segment, uint64_t* result) {
+    uint64_t pivot_byte = inverse_logarithmic_integral(n) / WHEEL_SIZE;
+
+    uint64_t below = 0;
+    status_t status = count_primes(WHEEL_SIZE * pivot_byte, &below);
+    if (status != SUCCESS) {
+        return status;
+    }
+
+    uint64_t reach = WHEEL_SIZE * pivot_byte + WHEEL_SIZE * pivot_byte / 8;
+    uint32_t* primes = NULL;
+    uint32_t prime_count = 0;
+    status = collect_sieving_primes((uint32_t)isqrt64(reach), &primes, &prime_count);
+    if (status != SUCCESS) {
+        return status;
+    }
+
+    if (below < n) {
+        uint64_t remaining = n - below;
+        for (uint64_t first = pivot_byte; ; first += SEGMENT_BYTES) {
+            sieve_segment(segment, first, SEGMENT_BYTES, UINT64_MAX, primes, prime_count);
+            uint32_t found = count_segment(segment);
+            if (remaining <= found) {
+                *result = WHEEL_SIZE * first + select_in_segment(segment, (uint32_t)remaining - 1);
+                break;
+            }
+            remaining -= found;
+        }
+    } else {
+        uint64_t remaining = below - n;
+        for (uint64_t end = pivot_byte; ; ) {
+            uint32_t length = end < SEGMENT_BYTES ? (uint32_t)end : SEGMENT_BYTES;
+            uint64_t first = end - length;
+
+            sieve_segment(segment, first, length, UINT64_MAX, primes, prime_count);
+            uint32_t found = count_segment(segment);
+            if (remaining < found) {
+                uint32_t k = found - 1 - (uint32_t)remaining;
+                *result = WHEEL_SIZE * first + select_in_segment(segment, k);
+                break;
+            }
+            remaining -= found;
+            end = first;
+        }
+    }
+
+    free(primes);
+    return SUCCESS;
+}
+
+/*
+ * Proven upper bound for p_n: n (ln n + ln ln n) for n >= 6 (Rosser), tightened by Dusart
+ * (2010) to n (ln n + ln ln n - 0.9484) for n >= 39017 and to
+ * n (ln n + ln ln n - 1 + (ln ln n - 2) / ln n) for n >= 688383.
+ */
+static uint64_t nth_prime_upper_bound(uint32_t n) {
+    if (n < 6) {
+        return 11;
+    }
+
+    double log_n = log((double)n);
+    double log_log_n = log(log_n);
+    double bound;
+    if (n >= 688383) {
+        bound = n * (log_n + log_log_n - 1.0 + (log_log_n - 2.0) / log_n);
+    } else if (n >= 39017) {
+        bound = n * (log_n + log_log_n - 0.9484);
+    } else {
+        bound = n * (log_n + log_log_n);
+    }
+    return (uint64_t)ceil(bound) + 1;
+}
+
+typedef struct {
+    uint32_t n;
+    size_t index;
+} prime_query_t;
+
+static int compare_queries(const void* a, const void* b) {
+    uint32_t lhs = ((const prime_query_t*)a)->n;
+    uint32_t rhs = ((const prime_query_t*)b)->n;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+/*
+ * Splits sorted queries between the shared sweep and per-query prime counting. Sweeping
+ * costs about one unit per integer up to the largest swept bound, while counting costs
+ * about COUNTING_COST_FACTOR * x^(3/4) plus one local segment for each query.
+ */
+static size_t choose_sweep_end(const prime_query_t* queries, size_t first, size_t count) {
+    size_t best_end = count;
+    double best_cost = (double)nth_prime_upper_bound(queries[count - 1].n);
+    double counting_cost = 0.0;
+
+    for (size_t end = count; end > first; end--) {
+        const prime_query_t* query = &queries[end - 1];
+        if (query->n < COUNTING_THRESHOLD) {
+            break;
+        }
+
+        double bound = (double)nth_prime_upper_bound(query->n);
+        counting_cost += COUNTING_COST_FACTOR * pow(bound, 0.75) + (double)SEGMENT_SPAN;
+
+        double sweep_cost = end - 1 > first
+            ? (double)nth_prime_upper_bound(queries[end - 2].n)
+            : 0.0;
+        if (sweep_cost + counting_cost < best_cost) {
+            best_cost = sweep_cost + counting_cost;
+            best_end = end - 1;
+        }
+    }
+
+    return best_end;
+}
+
+status_t find_nth_primes(const uint32_t* ns, size_t count, uint64_t* out) {
+    if (ns == NULL || out == NULL) {
+        return INVALID_INPUT;
+    }
+
+    if (count == 0) {
+        return SUCCESS;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (ns[i] == 0) {
+            return INVALID_INPUT;
+        }
+    }
+
+    prime_query_t* queries = (prime_query_t*)malloc(count * sizeof(prime_query_t));
+    if (!queries) {
+        return MEMORY_ERROR;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        queries[i].n = ns[i];
+        queries[i].index = i;
+    }
+    qsort(queries, count, sizeof(prime_query_t), compare_queries);
+
+    size_t first_wheel = 0;
+    while (first_wheel < count && queries[first_wheel].n <= 3) {
+        out[queries[first_wheel].index] = small_primes[queries[first_wheel].n - 1];
+        first_wheel++;
+    }
+
+    if (first_wheel == count) {
+        free(queries);
+        return SUCCESS;
+    }
+
+    uint8_t* segment = (uint8_t*)malloc(SEGMENT_BYTES);
+    if (!segment) {
+        free(queries);
+        return MEMORY_ERROR;
+    }
+
+    size_t sweep_end = choose_sweep_end(queries, first_wheel, count);
+
+    for (size_t i = sweep_end; i < count; i++) {
+        if (i > sweep_end && queries[i].n == queries[i - 1].n) {
+            out[queries[i].index] = out[queries[i - 1].index];
+            continue;
+        }
+        status_t status = find_nth_prime_by_counting(queries[i].n, segment, &out[queries[i].index]);
+        if (status != SUCCESS) {
+            free(segment);
+            free(queries);
+            return status;
+        }
+    }
+
+    if (sweep_end == first_wheel) {
+        free(segment);
+        free(queries);
+        return SUCCESS;
+    }
+
+    prime_sweep_t sweep;
+    status_t status = sweep_init(&sweep, nth_prime_upper_bound(queries[sweep_end - 1].n));
+
+    size_t next = first_wheel;
+    while (status == SUCCESS && next < sweep_end) {
+        if (!sweep_next(&sweep)) {
+            status = sweep_extend(&sweep, 2 * sweep.limit);
+            continue;
+        }
+
+        uint32_t position = 0;
+        uint32_t before = 0;
+        while (next < sweep_end && queries[next].n - 4 - sweep.before < sweep.found) {
+            uint32_t k = (uint32_t)(queries[next].n - 4 - sweep.before);
+            out[queries[next].index] = WHEEL_SIZE * sweep.first + select_from(sweep.segment, &position, &before, k);
+            next++;
+        }
+    }
+
+    sweep_free(&sweep);
+    free(segment);
+    free(queries);
+    return status;
+}
+
 status_t find_nth_prime(uint32_t n, uint64_t* result) {
     if (n == 0) {
         return INVALID_INPUT;
@@ -64,42 +662,617 @@ status_t find_nth_prime(uint32_t n, uint64_t* result) {
         return INVALID_INPUT;
     }
 
+    return find_nth_primes(&n, 1, result);
+}
+
+typedef struct {
+    pthread_mutex_t lock;
+    uint64_t head;
+    uint64_t tail;
+} segment_deque_t;
+
+typedef struct {
+    segment_deque_t* deques;
+    unsigned thread_count;
     uint64_t limit;
-    if (n < 6) {
-        limit = 12;
-    } else {
-        double log_n = log((double)n);
-        double log_log_n = log(log_n);
-        limit = (uint64_t)(n * (log_n + log_log_n));
-        if (limit < n) {
-            limit = n * 2;
+    const uint32_t* primes;
+    uint32_t prime_count;
+    uint32_t* counts;
+} parallel_sieve_t;
+
+typedef struct {
+    parallel_sieve_t* shared;
+    unsigned id;
+    status_t status;
+} sieve_worker_t;
+
+/* The owner pops segments from the head of its deque, thieves take them from the tail. */
+static bool take_segment(segment_deque_t* deque, bool steal, uint64_t* segment_index) {
+    bool taken = false;
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->head < deque->tail) {
+        *segment_index = steal ? --deque->tail : deque->head++;
+        taken = true;
+    }
+    pthread_mutex_unlock(&deque->lock);
+
+    return taken;
+}
+
+static void* run_sieve_worker(void* arg) {
+    sieve_worker_t* worker = (sieve_worker_t*)arg;
+    parallel_sieve_t* shared = worker->shared;
+
+    uint8_t* segment = (uint8_t*)malloc(SEGMENT_BYTES);
+    if (!segment) {
+        worker->status = MEMORY_ERROR;
+        return NULL;
+    }
+
+    unsigned victim = worker->id;
+    unsigned misses = 0;
+    while (misses < shared->thread_count) {
+        uint64_t index;
+        if (!take_segment(&shared->deques[victim], victim != worker->id, &index)) {
+            victim = (victim + 1) % shared->thread_count;
+            misses++;
+            continue;
         }
+        misses = 0;
+
+        uint64_t first = index * SEGMENT_BYTES;
+        uint32_t length = segment_length(first, shared->limit);
+
+        sieve_segment(segment, first, length, shared->limit, shared->primes, shared->prime_count);
+        shared->counts[index] = count_segment(segment);
+    }
+
+    free(segment);
+    worker->status = SUCCESS;
+    return NULL;
+}
+
+/*
+ * Counts the primes of segments [first_index, segment_count) on thread_count threads. Segments are
+ * dealt out as contiguous blocks, one deque per thread, and idle threads steal from the
+ * tails of the other deques. The calling thread works as worker 0, so the sieve still
+ * completes if some threads cannot be started.
+ */
+static status_t count_segments_parallel(uint64_t limit, const uint32_t* primes, uint32_t prime_count,
+                                        unsigned thread_count, uint32_t* counts,
+                                        uint64_t first_index, uint64_t segment_count) {
+    segment_deque_t* deques = (segment_deque_t*)malloc(thread_count * sizeof(segment_deque_t));
+    sieve_worker_t* workers = (sieve_worker_t*)malloc(thread_count * sizeof(sieve_worker_t));
+    pthread_t* threads = (pthread_t*)malloc(thread_count * sizeof(pthread_t));
+    bool* started = (bool*)calloc(thread_count, sizeof(bool));
+    if (!deques || !workers || !threads || !started) {
+        free(deques);
+        free(workers);
+        free(threads);
+        free(started);
+        return MEMORY_ERROR;
     }
 
+    parallel_sieve_t shared = { deques, thread_count, limit, primes, prime_count, counts };
+
+    for (unsigned i = 0; i < thread_count; i++) {
+        pthread_mutex_init(&deques[i].lock, NULL);
+        deques[i].head = first_index + (segment_count - first_index) * i / thread_count;
+        deques[i].tail = first_index + (segment_count - first_index) * (i + 1) / thread_count;
+        workers[i].shared = &shared;
+        workers[i].id = i;
+        workers[i].status = SUCCESS;
+    }
+
+    for (unsigned i = 1; i < thread_count; i++) {
+        started[i] = pthread_create(&threads[i], NULL, run_sieve_worker, &workers[i]) == 0;
+    }
+    run_sieve_worker(&workers[0]);
+
+    status_t status = SUCCESS;
+    for (unsigned i = 0; i < thread_count; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+        if (workers[i].status != SUCCESS && (i == 0 || started[i])) {
+            status = workers[i].status;
+        }
+        pthread_mutex_destroy(&deques[i].lock);
+    }
+
+    free(deques);
+    free(workers);
+    free(threads);
+    free(started);
+
+    return status;
+}
+
+status_t find_nth_prime_parallel(uint32_t n, unsigned thread_count, uint64_t* result) {
+    if (n == 0 || thread_count == 0) {
+        return INVALID_INPUT;
+    }
+    
+    if (result == NULL) {
+        return INVALID_INPUT;
+    }
+
+    if (n <= 3) {
+        *result = small_primes[n - 1];
+        return SUCCESS;
+    }
+
+    uint64_t limit = nth_prime_upper_bound(n);
+    uint32_t* primes = NULL;
+    uint32_t prime_count = 0;
+    status_t status = collect_sieving_primes((uint32_t)isqrt64(limit), &primes, &prime_count);
+    if (status != SUCCESS) {
+        return status;
+    }
+
+    uint32_t* counts = NULL;
+    uint64_t counted = 0;
+    uint64_t index = 0;
+    uint64_t remaining = n - 3;
+
     while (1) {
-        uint64_t* primes = NULL;
+        uint64_t segment_count = limit / WHEEL_SIZE / SEGMENT_BYTES + 1;
+        uint32_t* grown = (uint32_t*)realloc(counts, segment_count * sizeof(uint32_t));
+        if (!grown) {
+            status = MEMORY_ERROR;
+            break;
+        }
+        counts = grown;
+
+        status = count_segments_parallel(limit, primes, prime_count, thread_count, counts, counted, segment_count);
+        if (status != SUCCESS) {
+            break;
+        }
+
+        while (index < segment_count && remaining > counts[index]) {
+            remaining -= counts[index];
+            index++;
+        }
+        if (index < segment_count) {
+            break;
+        }
+
+        index = segment_count - 1;
+        remaining += counts[index];
+        counted = index;
+        limit *= 2;
+
+        free(primes);
+        primes = NULL;
+        status = collect_sieving_primes((uint32_t)isqrt64(limit), &primes, &prime_count);
+        if (status != SUCCESS) {
+            break;
+        }
+    }
+
+    if (status == SUCCESS) {
+        uint8_t* segment = (uint8_t*)malloc(SEGMENT_BYTES);
+        if (segment) {
+            uint64_t first = index * SEGMENT_BYTES;
+            sieve_segment(segment, first, segment_length(first, limit), limit, primes, prime_count);
+            *result = WHEEL_SIZE * first + select_in_segment(segment, (uint32_t)remaining - 1);
+            free(segment);
+        } else {
+            status = MEMORY_ERROR;
+        }
+    }
+
+    free(counts);
+    free(primes);
+    return status;
+}
+
+/*
+ * Sieves the segment after the iterator's current one. Sieving primes are collected up to
+ * the square root of a window that doubles as the iterator advances, so memory stays
+ * O(sqrt(x)) even without a finite stop.
+ */
+static status_t advance_iterator(prime_iterator_t* it) {
+    uint64_t next = it->first + it->length;
+    if (next > it->stop / WHEEL_SIZE) {
+        return OUT_OF_RANGE;
+    }
+
+    uint64_t end_value = next < UINT64_MAX / WHEEL_SIZE - SEGMENT_BYTES
+        ? WHEEL_SIZE * (next + SEGMENT_BYTES)
+        : UINT64_MAX;
+    if (end_value > it->stop) {
+        end_value = it->stop;
+    }
+
+    if (it->primes == NULL || end_value > it->limit) {
+        uint64_t limit = it->limit < UINT64_MAX / 2 ? 2 * it->limit : UINT64_MAX;
+        if (limit < end_value) {
+            limit = end_value;
+        }
+        if (limit > it->stop) {
+            limit = it->stop;
+        }
+
+        uint32_t* primes = NULL;
         uint32_t prime_count = 0;
-        status_t status = sieve_of_eratosthenes(limit, &primes, &prime_count);
-        
+        status_t status = collect_sieving_primes((uint32_t)isqrt64(limit), &primes, &prime_count);
         if (status != SUCCESS) {
             return status;
         }
-        
-        if (n <= prime_count) {
-            *result = primes[n - 1];
-            free(primes);
+
+        free(it->primes);
+        it->primes = primes;
+        it->prime_count = prime_count;
+        it->limit = limit;
+    }
+
+    it->first = next;
+    it->length = segment_length(next, it->stop);
+    it->position = 0;
+    it->candidates = 0;
+    sieve_segment(it->segment, next, it->length, it->stop, it->primes, it->prime_count);
+
+    return SUCCESS;
+}
+
+status_t prime_iterator_init(prime_iterator_t* it, uint64_t start, uint64_t stop) {
+    if (it == NULL) {
+        return INVALID_INPUT;
+    }
+
+    memset(it, 0, sizeof(*it));
+    it->stop = stop;
+
+    it->segment = (uint8_t*)malloc(SEGMENT_BYTES);
+    if (!it->segment) {
+        return MEMORY_ERROR;
+    }
+
+    return prime_iterator_skip_to(it, start);
+}
+
+status_t prime_iterator_next(prime_iterator_t* it, uint64_t* prime) {
+    if (it == NULL || it->segment == NULL || prime == NULL) {
+        return INVALID_INPUT;
+    }
+
+    while (it->small_index < 3) {
+        uint64_t candidate = small_primes[it->small_index++];
+        if (candidate > it->stop) {
+            return OUT_OF_RANGE;
+        }
+        if (candidate >= it->lower) {
+            *prime = candidate;
             return SUCCESS;
         }
-        
-        free(primes);
-        limit *= 2;
-        
-        if (limit < 1000000) {
-            limit *= 2;
-        } else {
-            limit += limit / 2;
+    }
+
+    while (1) {
+        while (it->candidates == 0) {
+            if (it->position >= it->length) {
+                status_t status = advance_iterator(it);
+                if (status != SUCCESS) {
+                    return status;
+                }
+                continue;
+            }
+            it->candidates = (uint8_t)~it->segment[it->position++];
         }
+
+        uint64_t candidate = WHEEL_SIZE * (it->first + it->position - 1)
+            + wheel_residues[__builtin_ctz(it->candidates)];
+        it->candidates &= it->candidates - 1;
+
+        if (candidate >= it->lower) {
+            *prime = candidate;
+            return SUCCESS;
+        }
+    }
+}
+
+status_t prime_iterator_skip_to(prime_iterator_t* it, uint64_t x) {
+    if (it == NULL || it->segment == NULL) {
+        return INVALID_INPUT;
+    }
+
+    uint64_t segment_start = WHEEL_SIZE * it->first;
+    uint64_t segment_end = segment_start + WHEEL_SIZE * (uint64_t)it->length;
+    if (it->length > 0 && x >= segment_start && x < segment_end) {
+        it->position = (uint32_t)((x - segment_start) / WHEEL_SIZE);
+        it->candidates = 0;
+    } else {
+        it->first = x / WHEEL_SIZE;
+        it->length = 0;
+        it->position = 0;
+        it->candidates = 0;
+    }
+
+    it->small_index = x > 5 ? 3 : 0;
+    it->lower = x;
+
+    return SUCCESS;
+}
+
+void prime_iterator_free(prime_iterator_t* it) {
+    if (it == NULL) {
+        return;
+    }
+
+    free(it->primes);
+    free(it->segment);
+    memset(it, 0, sizeof(*it));
+}
+
+/*
+ * Prime table file layout: a prime_table_header_t, then for each block of block_size odd
+ * primes the gaps after its first prime as LEB128 varints of gap / 2, then at index_offset
+ * one { first prime, data offset } pair per block.
+ */
+#define PRIME_TABLE_MAGIC "PRIMETBL"
+#define PRIME_TABLE_VERSION 1u
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t block_size;
+    uint64_t prime_count;
+    uint64_t block_count;
+    uint64_t index_offset;
+} prime_table_header_t;
+
+/* Writes value as a LEB128 varint and returns the number of bytes written, 0 on failure. */
+static size_t write_varint(FILE* file, uint64_t value) {
+    uint8_t buffer[10];
+    size_t length = 0;
+    do {
+        uint8_t byte = (uint8_t)(value & 0x7F);
+        value >>= 7;
+        buffer[length++] = value ? (uint8_t)(byte | 0x80) : byte;
+    } while (value);
+    return fwrite(buffer, 1, length, file) == length ? length : 0;
+}
+
+typedef struct {
+    FILE* file;
+    uint32_t block_size;
+    uint64_t prime_count;
+    uint64_t previous;
+    uint64_t offset;
+    uint64_t* index;
+    uint64_t index_capacity;
+} prime_table_writer_t;
+
+static status_t append_table_prime(prime_table_writer_t* writer, uint64_t prime) {
+    if (writer->prime_count % writer->block_size == 0) {
+        uint64_t block = writer->prime_count / writer->block_size;
+        if (2 * block + 2 > writer->index_capacity) {
+            uint64_t capacity = writer->index_capacity ? writer->index_capacity * 2 : 1024;
+            uint64_t* index = (uint64_t*)realloc(writer->index, capacity * sizeof(uint64_t));
+            if (!index) {
+                return MEMORY_ERROR;
+            }
+            writer->index = index;
+            writer->index_capacity = capacity;
+        }
+        writer->index[2 * block] = prime;
+        writer->index[2 * block + 1] = writer->offset;
+    } else {
+        size_t written = write_varint(writer->file, (prime - writer->previous) / 2);
+        if (written == 0) {
+            return FILE_ERROR;
+        }
+        writer->offset += written;
+    }
+
+    writer->previous = prime;
+    writer->prime_count++;
+    return SUCCESS;
+}
+
+static status_t write_table_primes(prime_table_writer_t* writer, uint64_t limit) {
+    prime_iterator_t it;
+    status_t status = prime_iterator_init(&it, 3, limit);
+
+    uint64_t prime;
+    while (status == SUCCESS && (status = prime_iterator_next(&it, &prime)) == SUCCESS) {
+        status = append_table_prime(writer, prime);
+    }
+
+    prime_iterator_free(&it);
+    return status == OUT_OF_RANGE ? SUCCESS : status;
+}
+
+status_t prime_table_build(const char* path, uint64_t limit, uint32_t block_size) {
+    if (path == NULL || block_size == 0 || limit < 3) {
+        return INVALID_INPUT;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return FILE_ERROR;
+    }
+
+    prime_table_header_t header;
+    memset(&header, 0, sizeof(header));
+    prime_table_writer_t writer = { file, block_size, 0, 0, sizeof(header), NULL, 0 };
+
+    status_t status = fwrite(&header, sizeof(header), 1, file) == 1 ? SUCCESS : FILE_ERROR;
+    if (status == SUCCESS) {
+        status = write_table_primes(&writer, limit);
+    }
+
+    uint64_t block_count = (writer.prime_count + block_size - 1) / block_size;
+    static const uint8_t padding[8] = { 0 };
+    uint64_t index_offset = (writer.offset + 7) & ~(uint64_t)7;
+
+    if (status == SUCCESS && fwrite(padding, 1, (size_t)(index_offset - writer.offset), file) != index_offset - writer.offset) {
+        status = FILE_ERROR;
+    }
+    if (status == SUCCESS && fwrite(writer.index, sizeof(uint64_t), 2 * block_count, file) != 2 * block_count) {
+        status = FILE_ERROR;
+    }
+
+    if (status == SUCCESS) {
+        memcpy(header.magic, PRIME_TABLE_MAGIC, sizeof(header.magic));
+        header.version = PRIME_TABLE_VERSION;
+        header.block_size = block_size;
+        header.prime_count = writer.prime_count;
+        header.block_count = block_count;
+        header.index_offset = index_offset;
+        if (fseek(file, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, file) != 1) {
+            status = FILE_ERROR;
+        }
+    }
+
+    free(writer.index);
+    if (fclose(file) != 0 && status == SUCCESS) {
+        status = FILE_ERROR;
     }
+    if (status != SUCCESS) {
+        remove(path);
+    }
+
+    return status;
+}
+
+status_t prime_table_open(const char* path, prime_table_t* table) {
+    if (path == NULL || table == NULL) {
+        return INVALID_INPUT;
+    }
+
+    memset(table, 0, sizeof(*table));
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return FILE_ERROR;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || (uint64_t)size.QuadPart < sizeof(prime_table_header_t)) {
+        CloseHandle(file);
+        return FILE_ERROR;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) {
+        return FILE_ERROR;
+    }
+
+    const uint8_t* base = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!base) {
+        CloseHandle(mapping);
+        return FILE_ERROR;
+    }
+
+    table->mapping = mapping;
+    uint64_t file_size = (uint64_t)size.QuadPart;
+#else
+    int file = open(path, O_RDONLY);
+    if (file < 0) {
+        return FILE_ERROR;
+    }
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || (uint64_t)info.st_size < sizeof(prime_table_header_t)) {
+        close(file);
+        return FILE_ERROR;
+    }
+
+    const uint8_t* base = (const uint8_t*)mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+    if (base == MAP_FAILED) {
+        return FILE_ERROR;
+    }
+
+    uint64_t file_size = (uint64_t)info.st_size;
+#endif
+
+    table->base = base;
+    table->size = (size_t)file_size;
+
+    prime_table_header_t header;
+    memcpy(&header, base, sizeof(header));
+
+    /* Counts come from the file, so they are bounded by the file size before any arithmetic. */
+    bool valid = memcmp(header.magic, PRIME_TABLE_MAGIC, sizeof(header.magic)) == 0
+        && header.version == PRIME_TABLE_VERSION
+        && header.block_size != 0
+        && header.index_offset % sizeof(uint64_t) == 0
+        && header.index_offset <= file_size
+        && header.block_count <= (file_size - header.index_offset) / (2 * sizeof(uint64_t))
+        && header.block_count == header.prime_count / header.block_size
+                                 + (header.prime_count % header.block_size != 0);
+
+    if (!valid) {
+        prime_table_close(table);
+        return FILE_ERROR;
+    }
+
+    table->block_size = header.block_size;
+    table->prime_count = header.prime_count;
+    table->block_count = header.block_count;
+    table->index = (const uint64_t*)(base + header.index_offset);
+    table->data_end = header.index_offset;
+
+    return SUCCESS;
+}
+
+status_t prime_table_nth(const prime_table_t* table, uint32_t n, uint64_t* result) {
+    if (table == NULL || table->base == NULL || n == 0 || result == NULL) {
+        return INVALID_INPUT;
+    }
+
+    if (n == 1) {
+        *result = 2;
+        return SUCCESS;
+    }
+
+    uint64_t position = n - 2;
+    if (position >= table->prime_count) {
+        return OUT_OF_RANGE;
+    }
+
+    uint64_t block = position / table->block_size;
+    uint64_t prime = table->index[2 * block];
+    uint64_t offset = table->index[2 * block + 1];
+
+    for (uint64_t i = position % table->block_size; i > 0; i--) {
+        uint64_t gap = 0;
+        int shift = 0;
+        uint8_t byte;
+        do {
+            if (offset >= table->data_end || shift > 56) {
+                return FILE_ERROR;
+            }
+            byte = table->base[offset++];
+            gap |= (uint64_t)(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        prime += 2 * gap;
+    }
+
+    *result = prime;
+    return SUCCESS;
+}
+
+void prime_table_close(prime_table_t* table) {
+    if (table == NULL || table->base == NULL) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(table->base);
+    CloseHandle(table->mapping);
+#else
+    munmap((void*)table->base, table->size);
+#endif
+
+    memset(table, 0, sizeof(*table));
 }
 
 status_t validate_input(int t, const int* queries, int query_count) {
@@ -129,6 +1302,12 @@ void print_results(const uint64_t* results, const int* queries, int count, const
             case MEMORY_ERROR:
                 printf("Memory error processing request: %d\n", queries[i]);
                 break;
+            case FILE_ERROR:
+                printf("Prime table error processing request: %d\n", queries[i]);
+                break;
+            case OUT_OF_RANGE:
+                printf("Request outside the prime table: %d\n", queries[i]);
+                break;
             default:
                 printf("Unknown error for request: %d\n", queries[i]);
                 break;
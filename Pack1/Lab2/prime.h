@@ -7,10 +7,50 @@
 typedef enum {
     SUCCESS = 0,
     INVALID_INPUT = 1,
-    MEMORY_ERROR = 2
+    MEMORY_ERROR = 2,
+    FILE_ERROR = 3,
+    OUT_OF_RANGE = 4
 } status_t;
 
+#define PRIME_TABLE_BLOCK_SIZE 64u
+
+typedef struct {
+    const uint8_t* base;
+    size_t size;
+    uint32_t block_size;
+    uint64_t prime_count;
+    uint64_t block_count;
+    const uint64_t* index;
+    uint64_t data_end;
+    void* mapping;
+} prime_table_t;
+
+typedef struct {
+    uint64_t stop;
+    uint64_t limit;
+    uint64_t lower;
+    uint32_t* primes;
+    uint32_t prime_count;
+    uint8_t* segment;
+    uint64_t first;
+    uint32_t length;
+    uint32_t position;
+    uint32_t candidates;
+    uint32_t small_index;
+} prime_iterator_t;
+
 status_t find_nth_prime(uint32_t n, uint64_t* result);
+status_t find_nth_primes(const uint32_t* ns, size_t count, uint64_t* out);
+status_t count_primes(uint64_t x, uint64_t* result);
+status_t find_nth_prime_parallel(uint32_t n, unsigned thread_count, uint64_t* result);
+status_t prime_table_build(const char* path, uint64_t limit, uint32_t block_size);
+status_t prime_table_open(const char* path, prime_table_t* table);
+status_t prime_table_nth(const prime_table_t* table, uint32_t n, uint64_t* result);
+void prime_table_close(prime_table_t* table);
+status_t prime_iterator_init(prime_iterator_t* it, uint64_t start, uint64_t stop);
+status_t prime_iterator_next(prime_iterator_t* it, uint64_t* prime);
+status_t prime_iterator_skip_to(prime_iterator_t* it, uint64_t x);
+void prime_iterator_free(prime_iterator_t* it);
 status_t validate_input(int t, const int* queries, int query_count);
 void print_results(const uint64_t* results, const int* queries, int count, const status_t* statuses);
 
@@ -3,7 +3,10 @@
 #include <string.h>
 #include <math.h>
 #include <errno.h>
+#include <time.h>
 #include "operations.h"
+#include "polynomial.h"
+#include "stream.h"
 
 
 void print_usage() {
@@ -11,6 +14,11 @@ void print_usage() {
     printf("  -q <epsilon> <a> <b> <c> - Solve quadratic equation with all permutations\n");
     printf("  -m <num1> <num2>          - Check if first number is multiple of second\n");
     printf("  -t <epsilon> <a> <b> <c>  - Check if numbers can form a right triangle\n");
+    printf("  -p <c0> <c1> ... <cn>     - Find all roots of c0 x^n + ... + cn\n");
+    printf("  --csv -q <epsilon> <file> [threads] - Solve all permutations of each a,b,c row of a CSV file\n");
+    printf("  --csv -m <file> [threads]           - Check each num1,num2 row of a CSV file\n");
+    printf("  --csv -t <epsilon> <file> [threads] - Check each a,b,c row of a CSV file\n");
+    printf("  --bench-poly <degree> <count>       - Time the batch polynomial solver\n");
 }
 
 
@@ -51,6 +59,151 @@ bool parse_int(const char *str, int *value) {
 }
 
 
+int run_csv(int argc, char *argv[]) {
+    if (argc < 4) {
+        fprintf(stderr, "Error: --csv expects an operation and a file\n");
+        return 1;
+    }
+    
+    const char *operation_flag = argv[2];
+    StreamOperation operation;
+    
+    if (strcmp(operation_flag, "-q") == 0 || strcmp(operation_flag, "/q") == 0) {
+        operation = STREAM_QUADRATIC;
+    } else if (strcmp(operation_flag, "-m") == 0 || strcmp(operation_flag, "/m") == 0) {
+        operation = STREAM_MULTIPLE;
+    } else if (strcmp(operation_flag, "-t") == 0 || strcmp(operation_flag, "/t") == 0) {
+        operation = STREAM_TRIANGLE;
+    } else {
+        fprintf(stderr, "Error: Unknown operation '%s' for --csv\n", operation_flag);
+        return 1;
+    }
+    
+    int next = 3;
+    double epsilon = 0.0;
+    
+    if (operation != STREAM_MULTIPLE) {
+        if (!parse_double(argv[next], &epsilon) || epsilon <= 0) {
+            fprintf(stderr, "Error: Epsilon must be a positive number\n");
+            return 1;
+        }
+        next++;
+    }
+    
+    if (next >= argc || argc > next + 2) {
+        fprintf(stderr, "Error: --csv expects <file> [threads] after the operation\n");
+        return 1;
+    }
+    
+    const char *path = argv[next];
+    int thread_count = default_thread_count();
+    
+    if (next + 1 < argc && (!parse_int(argv[next + 1], &thread_count) || thread_count < 1)) {
+        fprintf(stderr, "Error: Thread count must be a positive integer\n");
+        return 1;
+    }
+    
+    StreamStatus status = process_csv_stream(path, operation, epsilon, thread_count, stdout);
+    if (status != STREAM_SUCCESS) {
+        print_stream_status(status);
+        printf("\n");
+        return 1;
+    }
+    
+    return 0;
+}
+
+
+int run_polynomial(int argc, char *argv[]) {
+    int degree = argc - 3;
+    if (degree < 1 || degree > POLYNOMIAL_MAX_DEGREE) {
+        fprintf(stderr, "Error: For -p flag, expected between 2 and %d coefficients\n", POLYNOMIAL_MAX_DEGREE + 1);
+        return 1;
+    }
+    
+    double coefficients[POLYNOMIAL_MAX_DEGREE + 1];
+    for (int k = 0; k <= degree; k++) {
+        if (!parse_double(argv[k + 2], &coefficients[k])) {
+            fprintf(stderr, "Error: Invalid number format\n");
+            return 1;
+        }
+    }
+    
+    double roots_real[POLYNOMIAL_MAX_DEGREE];
+    double roots_imag[POLYNOMIAL_MAX_DEGREE];
+    PolynomialStatus status = solve_polynomial(coefficients, degree, roots_real, roots_imag);
+    
+    if (status != POLYNOMIAL_SUCCESS && status != POLYNOMIAL_NO_CONVERGENCE) {
+        print_polynomial_status(status);
+        printf("\n");
+        return 1;
+    }
+    
+    print_polynomial_roots(roots_real, roots_imag, degree);
+    if (status == POLYNOMIAL_NO_CONVERGENCE) {
+        print_polynomial_status(status);
+        printf("\n");
+    }
+    
+    return 0;
+}
+
+
+int run_polynomial_benchmark(int argc, char *argv[]) {
+    int degree, count;
+    if (argc != 4 || !parse_int(argv[2], &degree) || !parse_int(argv[3], &count) ||
+        degree < 1 || degree > POLYNOMIAL_MAX_DEGREE || count < 1) {
+        fprintf(stderr, "Error: --bench-poly expects <degree 1..%d> <count>\n", POLYNOMIAL_MAX_DEGREE);
+        return 1;
+    }
+    
+    size_t n = (size_t)count;
+    double *coefficients = (double*)malloc((size_t)(degree + 1) * n * sizeof(double));
+    double *roots_real = (double*)malloc((size_t)degree * n * sizeof(double));
+    double *roots_imag = (double*)malloc((size_t)degree * n * sizeof(double));
+    PolynomialStatus *statuses = (PolynomialStatus*)malloc(n * sizeof(PolynomialStatus));
+    
+    if (coefficients == NULL || roots_real == NULL || roots_imag == NULL || statuses == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        free(coefficients);
+        free(roots_real);
+        free(roots_imag);
+        free(statuses);
+        return 1;
+    }
+    
+    srand(12345);
+    for (size_t i = 0; i < (size_t)(degree + 1) * n; i++) {
+        coefficients[i] = 2.0 * rand() / RAND_MAX - 1.0;
+    }
+    for (size_t p = 0; p < n; p++) {
+        if (coefficients[p] == 0) coefficients[p] = 1.0;
+    }
+    
+    clock_t start = clock();
+    PolynomialStatus status = solve_polynomial_batch(degree, coefficients, n, roots_real, roots_imag, statuses);
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    
+    if (status != POLYNOMIAL_SUCCESS) {
+        print_polynomial_status(status);
+        printf("\n");
+    } else {
+        size_t converged = 0;
+        for (size_t p = 0; p < n; p++) {
+            converged += statuses[p] == POLYNOMIAL_SUCCESS;
+        }
+        printf("Degree %d: %zu polynomials in %.3f s (%.0f polynomials/s), %zu converged\n",
+               degree, n, seconds, seconds > 0 ? n / seconds : 0.0, converged);
+    }
+    
+    free(coefficients);
+    free(roots_real);
+    free(roots_imag);
+    free(statuses);
+    return status == POLYNOMIAL_SUCCESS ? 0 : 1;
+}
+
+
 int main(int argc, char *argv[]) {
     if (argc < 2) {
         fprintf(stderr, "Error: No flag provided\n");
@@ -60,6 +213,18 @@ int main(int argc, char *argv[]) {
 
     char *flag = argv[1];
     
+    if (strcmp(flag, "--csv") == 0) {
+        return run_csv(argc, argv);
+    }
+    
+    if (strcmp(flag, "--bench-poly") == 0) {
+        return run_polynomial_benchmark(argc, argv);
+    }
+    
+    if (strcmp(flag, "-p") == 0 || strcmp(flag, "/p") == 0) {
+        return run_polynomial(argc, argv);
+    }
+    
     if (strcmp(flag, "-q") == 0 || strcmp(flag, "/q") == 0) {
         if (argc != 6) {
             fprintf(stderr, "Error: For -q flag, expected 5 arguments (flag + 4 numbers), got %d\n", argc);
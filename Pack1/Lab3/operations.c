@@ -3,6 +3,12 @@
 #include <math.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <string.h>
+#include <float.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define OPERATIONS_AVX2
+#endif
 
 
 static void swap(double *a, double *b) {
@@ -12,6 +18,12 @@ static void swap(double *a, double *b) {
 }
 
 
+/* The root c / q, with the sign (-b +- sqrt(D)) / 2a gives it when c is zero. */
+static double zero_root(double a, double c, double q) {
+    return c != 0 ? c / q : copysign(0.0, a);
+}
+
+
 QuadraticStatus solve_quadratic_equation(double epsilon, double a, double b, double c, QuadraticSolution *solution) {
     if (solution == NULL) {
         return QUADRATIC_INVALID_PARAMS;
@@ -35,22 +47,223 @@ QuadraticStatus solve_quadratic_equation(double epsilon, double a, double b, dou
         }
     }
     
-    double discriminant = b * b - 4 * a * c;
+    double discriminant = b * b - 4 * (a * c);
+    double threshold = epsilon;
+    
+    /* b * b - 4 * (a * c) overflowed; the roots do not change when a, b, c are divided by the largest of them. */
+    if (!isfinite(discriminant)) {
+        double inverse = 1.0 / fmax(fabs(a), fmax(fabs(b), fabs(c)));
+        a *= inverse;
+        b *= inverse;
+        c *= inverse;
+        discriminant = b * b - 4 * (a * c);
+        threshold = epsilon * inverse * inverse;
+    }
     
-    if (discriminant < -epsilon) {
+    if (discriminant < -threshold) {
         return QUADRATIC_NO_REAL_ROOTS;
     }
     
-    if (fabs(discriminant) <= epsilon) {
+    if (fabs(discriminant) <= threshold) {
         solution->root_count = 1;
         solution->root1 = -b / (2 * a);
     } else {
         solution->root_count = 2;
-        double sqrt_discriminant = sqrt(discriminant);
-        solution->root1 = (-b - sqrt_discriminant) / (2 * a);
-        solution->root2 = (-b + sqrt_discriminant) / (2 * a);
+        double q = -0.5 * (b + copysign(sqrt(discriminant), b));
+        solution->root1 = q / a;
+        solution->root2 = zero_root(a, c, q);
+        if (signbit(b)) {
+            swap(&solution->root1, &solution->root2);
+        }
+    }
+    
+    return QUADRATIC_SUCCESS;
+}
+
+
+/*
+ * The discriminant is written b * b - 4 * (a * c) so that (a, b, c) and its mirror (c, b, a) get
+ * the same bits. The mirror then shares the scale, the discriminant and q = -(b + sign(b) sqrt(D)) / 2.
+ */
+typedef struct {
+    double inverse;
+    double threshold;
+    double discriminant;
+    double q;
+} SharedDiscriminant;
+
+static SharedDiscriminant share_discriminant(double epsilon, double a, double b, double c) {
+    SharedDiscriminant shared;
+    double unscaled = b * b - 4 * (a * c);
+    shared.inverse = isfinite(unscaled) ? 1.0 : 1.0 / fmax(fabs(a), fmax(fabs(b), fabs(c)));
+    double sa = a * shared.inverse;
+    double sb = b * shared.inverse;
+    double sc = c * shared.inverse;
+    shared.threshold = epsilon * shared.inverse * shared.inverse;
+    shared.discriminant = sb * sb - 4 * (sa * sc);
+    bool negative = shared.discriminant < -shared.threshold;
+    shared.q = -0.5 * (sb + copysign(sqrt(negative ? 0.0 : shared.discriminant), sb));
+    return shared;
+}
+
+/*
+ * One lane of solve_quadratic_batch: every case is evaluated and one is kept with
+ * selects, so the result matches solve_quadratic_equation without branching on the input.
+ */
+static void solve_quadratic_lane(double epsilon, const SharedDiscriminant *shared, double a, double b, double c,
+                                 double *root1, double *root2, int *root_count, QuadraticStatus *status) {
+    bool linear = fabs(a) <= epsilon;
+    bool constant = fabs(b) <= epsilon;
+    bool zero = fabs(c) <= epsilon;
+    
+    double sa = a * shared->inverse;
+    double sb = b * shared->inverse;
+    double sc = c * shared->inverse;
+    bool negative = shared->discriminant < -shared->threshold;
+    bool double_root = fabs(shared->discriminant) <= shared->threshold;
+    
+    double near = shared->q / sa;
+    double far = zero_root(sa, sc, shared->q);
+    double low = signbit(b) ? far : near;
+    double high = signbit(b) ? near : far;
+    
+    int quadratic_count = negative ? 0 : (double_root ? 1 : 2);
+    int linear_count = constant ? 0 : 1;
+    QuadraticStatus quadratic_status = negative ? QUADRATIC_NO_REAL_ROOTS : QUADRATIC_SUCCESS;
+    QuadraticStatus linear_status = constant ? (zero ? QUADRATIC_IDENTITY : QUADRATIC_NO_REAL_ROOTS)
+                                             : QUADRATIC_LINEAR_EQUATION;
+    
+    int count = linear ? linear_count : quadratic_count;
+    *root_count = count;
+    *status = linear ? linear_status : quadratic_status;
+    *root1 = count > 0 ? (linear ? -c / b : (double_root ? -sb / (2 * sa) : low)) : 0.0;
+    *root2 = count > 1 ? high : 0.0;
+}
+
+#ifdef OPERATIONS_AVX2
+#define AVX2_INLINE static inline __attribute__((target("avx2"), always_inline))
+
+/* share_discriminant for four lanes. */
+AVX2_INLINE void share_discriminant_avx2(double epsilon, __m256d va, __m256d vb, __m256d vc, __m256d *inverse,
+                                         __m256d *threshold, __m256d *discriminant, __m256d *q) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d four = _mm256_set1_pd(4.0);
+    
+    __m256d unscaled = _mm256_sub_pd(_mm256_mul_pd(vb, vb), _mm256_mul_pd(four, _mm256_mul_pd(va, vc)));
+    __m256d finite = _mm256_cmp_pd(_mm256_andnot_pd(sign, unscaled), _mm256_set1_pd(DBL_MAX), _CMP_LE_OQ);
+    __m256d largest = _mm256_max_pd(_mm256_andnot_pd(sign, va),
+                                    _mm256_max_pd(_mm256_andnot_pd(sign, vb), _mm256_andnot_pd(sign, vc)));
+    *inverse = _mm256_div_pd(one, _mm256_blendv_pd(largest, one, finite));
+    __m256d sa = _mm256_mul_pd(va, *inverse);
+    __m256d sb = _mm256_mul_pd(vb, *inverse);
+    __m256d sc = _mm256_mul_pd(vc, *inverse);
+    *threshold = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(epsilon), *inverse), *inverse);
+    
+    *discriminant = _mm256_sub_pd(_mm256_mul_pd(sb, sb), _mm256_mul_pd(four, _mm256_mul_pd(sa, sc)));
+    __m256d negative = _mm256_cmp_pd(*discriminant, _mm256_xor_pd(*threshold, sign), _CMP_LT_OQ);
+    __m256d root = _mm256_sqrt_pd(_mm256_andnot_pd(negative, *discriminant));
+    *q = _mm256_mul_pd(_mm256_set1_pd(-0.5), _mm256_add_pd(sb, _mm256_or_pd(root, _mm256_and_pd(sb, sign))));
+}
+
+/* solve_quadratic_lane for four lanes with AVX2 compares and blends. */
+AVX2_INLINE void solve_quadratic_avx2(double epsilon, __m256d inverse, __m256d threshold, __m256d discriminant, __m256d q,
+                                      __m256d va, __m256d vb, __m256d vc,
+                                      double *root1, double *root2, int *root_count, QuadraticStatus *statuses) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d eps = _mm256_set1_pd(epsilon);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    
+    __m256d linear = _mm256_cmp_pd(_mm256_andnot_pd(sign, va), eps, _CMP_LE_OQ);
+    __m256d constant = _mm256_cmp_pd(_mm256_andnot_pd(sign, vb), eps, _CMP_LE_OQ);
+    __m256d vanishing = _mm256_cmp_pd(_mm256_andnot_pd(sign, vc), eps, _CMP_LE_OQ);
+    
+    __m256d sa = _mm256_mul_pd(va, inverse);
+    __m256d sb = _mm256_mul_pd(vb, inverse);
+    __m256d sc = _mm256_mul_pd(vc, inverse);
+    __m256d negative = _mm256_cmp_pd(discriminant, _mm256_xor_pd(threshold, sign), _CMP_LT_OQ);
+    __m256d double_root = _mm256_cmp_pd(_mm256_andnot_pd(sign, discriminant), threshold, _CMP_LE_OQ);
+    
+    __m256d near = _mm256_div_pd(q, sa);
+    __m256d far = _mm256_blendv_pd(_mm256_div_pd(sc, q), _mm256_and_pd(sa, sign),
+                                   _mm256_cmp_pd(sc, zero, _CMP_EQ_OQ));
+    __m256d low = _mm256_blendv_pd(near, far, vb);
+    __m256d high = _mm256_blendv_pd(far, near, vb);
+    
+    __m256d quadratic_root = _mm256_blendv_pd(low, _mm256_div_pd(_mm256_xor_pd(sb, sign), _mm256_mul_pd(two, sa)), double_root);
+    __m256d linear_root = _mm256_div_pd(_mm256_xor_pd(vc, sign), vb);
+    
+    __m256d quadratic_count = _mm256_blendv_pd(_mm256_blendv_pd(two, one, double_root), zero, negative);
+    __m256d linear_count = _mm256_blendv_pd(one, zero, constant);
+    __m256d count = _mm256_blendv_pd(quadratic_count, linear_count, linear);
+    
+    __m256d quadratic_status = _mm256_blendv_pd(_mm256_set1_pd(QUADRATIC_SUCCESS), _mm256_set1_pd(QUADRATIC_NO_REAL_ROOTS), negative);
+    __m256d linear_status = _mm256_blendv_pd(_mm256_set1_pd(QUADRATIC_LINEAR_EQUATION),
+                                             _mm256_blendv_pd(_mm256_set1_pd(QUADRATIC_NO_REAL_ROOTS), _mm256_set1_pd(QUADRATIC_IDENTITY), vanishing),
+                                             constant);
+    __m256d status = _mm256_blendv_pd(quadratic_status, linear_status, linear);
+    
+    __m256d first = _mm256_blendv_pd(quadratic_root, linear_root, linear);
+    _mm256_storeu_pd(root1, _mm256_and_pd(first, _mm256_cmp_pd(count, zero, _CMP_GT_OQ)));
+    _mm256_storeu_pd(root2, _mm256_and_pd(high, _mm256_cmp_pd(count, one, _CMP_GT_OQ)));
+    _mm_storeu_si128((__m128i *)root_count, _mm256_cvtpd_epi32(count));
+    _mm_storeu_si128((__m128i *)statuses, _mm256_cvtpd_epi32(status));
+}
+
+/* Four equations, or four mirrored pairs when mirrored is set; called only when the CPU has AVX2. */
+__attribute__((target("avx2")))
+static void solve_quadratic_block_avx2(double epsilon, const double *a, const double *b, const double *c, bool mirrored,
+                                       size_t stride, double *root1, double *root2, int *root_count, QuadraticStatus *statuses) {
+    __m256d va = _mm256_loadu_pd(a);
+    __m256d vb = _mm256_loadu_pd(b);
+    __m256d vc = _mm256_loadu_pd(c);
+    __m256d inverse, threshold, discriminant, q;
+    
+    share_discriminant_avx2(epsilon, va, vb, vc, &inverse, &threshold, &discriminant, &q);
+    solve_quadratic_avx2(epsilon, inverse, threshold, discriminant, q, va, vb, vc,
+                         root1, root2, root_count, statuses);
+    if (mirrored) {
+        solve_quadratic_avx2(epsilon, inverse, threshold, discriminant, q, vc, vb, va,
+                             root1 + stride, root2 + stride, root_count + stride, statuses + stride);
+    }
+}
+#endif
+
+/*
+ * Solves (a, b, c) into the first n outputs and, when mirrored is set, (c, b, a) into the
+ * next n from the same discriminant.
+ */
+static void solve_quadratic_lanes(double epsilon, const double *a, const double *b, const double *c, size_t n, bool mirrored,
+                                  double *root1, double *root2, int *root_count, QuadraticStatus *statuses) {
+    size_t i = 0;
+#ifdef OPERATIONS_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        for (; i + 4 <= n; i += 4) {
+            solve_quadratic_block_avx2(epsilon, a + i, b + i, c + i, mirrored, n,
+                                       root1 + i, root2 + i, root_count + i, statuses + i);
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        SharedDiscriminant shared = share_discriminant(epsilon, a[i], b[i], c[i]);
+        solve_quadratic_lane(epsilon, &shared, a[i], b[i], c[i], &root1[i], &root2[i], &root_count[i], &statuses[i]);
+        if (mirrored) {
+            solve_quadratic_lane(epsilon, &shared, c[i], b[i], a[i],
+                                 &root1[n + i], &root2[n + i], &root_count[n + i], &statuses[n + i]);
+        }
+    }
+}
+
+QuadraticStatus solve_quadratic_batch(double epsilon, const double *a, const double *b, const double *c, size_t n,
+                                      double *root1, double *root2, int *root_count, QuadraticStatus *statuses) {
+    if (a == NULL || b == NULL || c == NULL || root1 == NULL || root2 == NULL ||
+        root_count == NULL || statuses == NULL) {
+        return QUADRATIC_INVALID_PARAMS;
     }
     
+    solve_quadratic_lanes(epsilon, a, b, c, n, false, root1, root2, root_count, statuses);
     return QUADRATIC_SUCCESS;
 }
 
@@ -64,7 +277,82 @@ MultipleStatus check_multiple(int num1, int num2, bool *is_multiple) {
         return MULTIPLE_DIVISION_BY_ZERO;
     }
     
-    *is_multiple = (num1 % num2 == 0);
+    /* INT_MIN % -1 traps on x86; every number is a multiple of -1. */
+    *is_multiple = num2 == -1 || num1 % num2 == 0;
+    return MULTIPLE_SUCCESS;
+}
+
+
+/*
+ * Divisibility by d = 2^k * m with m odd, without dividing: |n| is a multiple of d exactly
+ * when |n| * m^-1 mod 2^32, rotated right by k, is at most (2^32 - 1) / d. The caller
+ * passes that bound as ((2^32 - 1) / m) >> k, which keeps GCC from turning the compare
+ * into an overflow check it cannot vectorize.
+ */
+static void mark_multiples(const int *nums, size_t n, uint32_t inverse, unsigned shift, uint32_t bound, uint8_t *out) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t value = (uint32_t)nums[i];
+        uint32_t magnitude = nums[i] < 0 ? 0u - value : value;
+        uint32_t product = magnitude * inverse;
+        uint32_t rotated = (product >> shift) | (product << ((32 - shift) & 31));
+        out[i] = rotated <= bound;
+    }
+}
+
+#ifdef OPERATIONS_AVX2
+/* mark_multiples eight numbers at a time; called only when the CPU has AVX2. Returns how many it marked. */
+__attribute__((target("avx2")))
+static size_t mark_multiples_avx2(const int *nums, size_t n, uint32_t inverse, unsigned shift, uint32_t bound, uint8_t *out) {
+    const __m256i vinverse = _mm256_set1_epi32((int)inverse);
+    const __m256i vbound = _mm256_set1_epi32((int)bound);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m128i right = _mm_cvtsi32_si128((int)shift);
+    const __m128i left = _mm_cvtsi32_si128((int)(32 - shift));  /* a shift by 32 gives 0, as the rotate needs */
+    
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i magnitude = _mm256_abs_epi32(_mm256_loadu_si256((const __m256i *)(nums + i)));
+        __m256i product = _mm256_mullo_epi32(magnitude, vinverse);
+        __m256i rotated = _mm256_or_si256(_mm256_srl_epi32(product, right), _mm256_sll_epi32(product, left));
+        __m256i marked = _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_min_epu32(rotated, vbound), rotated), one);
+        
+        __m256i words = _mm256_packs_epi32(marked, marked);
+        __m256i bytes = _mm256_packs_epi16(words, words);
+        int low = _mm_cvtsi128_si32(_mm256_castsi256_si128(bytes));
+        int high = _mm_cvtsi128_si32(_mm256_extracti128_si256(bytes, 1));
+        memcpy(out + i, &low, 4);
+        memcpy(out + i + 4, &high, 4);
+    }
+    return i;
+}
+#endif
+
+MultipleStatus check_multiple_batch(const int *nums, size_t n, int divisor, uint8_t *out) {
+    if (nums == NULL || out == NULL) {
+        return MULTIPLE_INVALID_PARAMS;
+    }
+    
+    if (divisor == 0) {
+        return MULTIPLE_DIVISION_BY_ZERO;
+    }
+    
+    uint32_t d = divisor < 0 ? 0u - (uint32_t)divisor : (uint32_t)divisor;
+    unsigned shift = (unsigned)__builtin_ctz(d);
+    uint32_t odd = d >> shift;
+    
+    uint32_t inverse = odd;
+    for (int i = 0; i < 4; i++) {
+        inverse *= 2 - odd * inverse;
+    }
+    
+    uint32_t bound = (UINT32_MAX / odd) >> shift;
+    size_t done = 0;
+#ifdef OPERATIONS_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        done = mark_multiples_avx2(nums, n, inverse, shift, bound, out);
+    }
+#endif
+    mark_multiples(nums + done, n - done, inverse, shift, bound, out + done);
     return MULTIPLE_SUCCESS;
 }
 
@@ -98,33 +386,72 @@ TriangleStatus check_right_triangle(double epsilon, double a, double b, double c
 }
 
 
+static const int permutations[6][3] = {
+    {0, 1, 2}, {0, 2, 1}, {1, 0, 2},
+    {1, 2, 0}, {2, 0, 1}, {2, 1, 0}
+};
+
+#define PERMUTATION_GROUP 64
+
+/* Orderings with the same middle coefficient are mirrors and share b * b - 4 * (a * c). */
+static const int mirror_pairs[3][2] = {{0, 5}, {1, 3}, {2, 4}};
+
 QuadraticStatus solve_quadratic_with_permutations(double epsilon, double a, double b, double c, PermutationsResult *result) {
-    if (result == NULL) {
+    return solve_quadratic_permutations_batch(epsilon, &a, &b, &c, 1, result);
+}
+
+/*
+ * Each input gives three mirrored pairs, so three discriminants cover its six orderings.
+ * The pairs of PERMUTATION_GROUP inputs at a time are laid out as a, b, c arrays and
+ * solved together by solve_quadratic_lanes.
+ */
+QuadraticStatus solve_quadratic_permutations_batch(double epsilon, const double *a, const double *b, const double *c,
+                                                   size_t n, PermutationsResult *results) {
+    if (a == NULL || b == NULL || c == NULL || results == NULL) {
         return QUADRATIC_INVALID_PARAMS;
     }
     
-    double coefficients[3] = {a, b, c};
-    int permutations[6][3] = {
-        {0, 1, 2}, {0, 2, 1}, {1, 0, 2},
-        {1, 2, 0}, {2, 0, 1}, {2, 1, 0}
-    };
+    double pa[PERMUTATION_GROUP * 3], pb[PERMUTATION_GROUP * 3], pc[PERMUTATION_GROUP * 3];
+    double root1[PERMUTATION_GROUP * 6], root2[PERMUTATION_GROUP * 6];
+    int root_count[PERMUTATION_GROUP * 6];
+    QuadraticStatus statuses[PERMUTATION_GROUP * 6];
     
-    for (int i = 0; i < 6; i++) {
-        double perm_a = coefficients[permutations[i][0]];
-        double perm_b = coefficients[permutations[i][1]];
-        double perm_c = coefficients[permutations[i][2]];
+    for (size_t start = 0; start < n; start += PERMUTATION_GROUP) {
+        size_t group = n - start < PERMUTATION_GROUP ? n - start : PERMUTATION_GROUP;
+        size_t count = group * 3;
+        
+        for (size_t i = 0; i < group; i++) {
+            PermutationsResult *result = &results[start + i];
+            double coefficients[3] = {a[start + i], b[start + i], c[start + i]};
+            
+            for (int p = 0; p < 6; p++) {
+                for (int k = 0; k < 3; k++) {
+                    result->coefficients[p][k] = coefficients[permutations[p][k]];
+                }
+            }
+            for (int k = 0; k < 3; k++) {
+                const double *first = result->coefficients[mirror_pairs[k][0]];
+                pa[i * 3 + k] = first[0];
+                pb[i * 3 + k] = first[1];
+                pc[i * 3 + k] = first[2];
+            }
+        }
         
-        result->coefficients[i][0] = perm_a;
-        result->coefficients[i][1] = perm_b;
-        result->coefficients[i][2] = perm_c;
+        solve_quadratic_lanes(epsilon, pa, pb, pc, count, true, root1, root2, root_count, statuses);
         
-        result->statuses[i] = solve_quadratic_equation(
-            epsilon, 
-            perm_a, 
-            perm_b, 
-            perm_c, 
-            &result->solutions[i]
-        );
+        for (size_t i = 0; i < group; i++) {
+            PermutationsResult *result = &results[start + i];
+            for (int k = 0; k < 3; k++) {
+                for (int side = 0; side < 2; side++) {
+                    size_t slot = side * count + i * 3 + k;
+                    int p = mirror_pairs[k][side];
+                    result->solutions[p].root1 = root1[slot];
+                    result->solutions[p].root2 = root2[slot];
+                    result->solutions[p].root_count = root_count[slot];
+                    result->statuses[p] = statuses[slot];
+                }
+            }
+        }
     }
     
     return QUADRATIC_SUCCESS;
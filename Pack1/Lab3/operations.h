@@ -2,6 +2,8 @@
 #define OPERATIONS_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 typedef enum {
     QUADRATIC_SUCCESS = 0,
@@ -37,10 +39,15 @@ typedef struct {
 } PermutationsResult;
 
 QuadraticStatus solve_quadratic_equation(double epsilon, double a, double b, double c, QuadraticSolution *solution);
+QuadraticStatus solve_quadratic_batch(double epsilon, const double *a, const double *b, const double *c, size_t n,
+                                      double *root1, double *root2, int *root_count, QuadraticStatus *statuses);
 MultipleStatus check_multiple(int num1, int num2, bool *is_multiple);
+MultipleStatus check_multiple_batch(const int *nums, size_t n, int divisor, uint8_t *out);
 TriangleStatus check_right_triangle(double epsilon, double a, double b, double c, bool *is_right_triangle);
 
 QuadraticStatus solve_quadratic_with_permutations(double epsilon, double a, double b, double c, PermutationsResult *result);
+QuadraticStatus solve_quadratic_permutations_batch(double epsilon, const double *a, const double *b, const double *c,
+                                                   size_t n, PermutationsResult *results);
 
 void print_solution(const QuadraticSolution *solution);
 void print_quadratic_status(QuadraticStatus status);
@@ -0,0 +1,302 @@
+#include "polynomial.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <float.h>
+#include <math.h>
+
+#define POLYNOMIAL_BLOCK 64
+#define ABERTH_MAX_ITERATIONS 200
+#define ABERTH_TOLERANCE 1e-13
+#define PI 3.14159265358979323846
+
+
+/* Degree 1 and 2 in closed form, with q = -(b + sign(b) sqrt(D)) / 2 for real roots. */
+static void solve_low_degree(int degree, const double *coefficients, size_t count,
+                             double *roots_real, double *roots_imag, PolynomialStatus *statuses) {
+    for (size_t p = 0; p < count; p++) {
+        double a = coefficients[p];
+        double b = coefficients[count + p];
+        bool degenerate = a == 0 || !isfinite(a);
+        statuses[p] = degenerate ? POLYNOMIAL_DEGENERATE : POLYNOMIAL_SUCCESS;
+
+        if (degree == 1) {
+            roots_real[p] = degenerate ? NAN : -b / a;
+            roots_imag[p] = degenerate ? NAN : 0.0;
+            continue;
+        }
+
+        double c = coefficients[2 * count + p];
+        double discriminant = b * b - 4 * a * c;
+        double root = sqrt(fabs(discriminant));
+        bool real = discriminant >= 0;
+
+        double q = -0.5 * (b + copysign(root, b));
+        double near = q / a;
+        double far = q != 0 ? c / q : 0.0;
+        double center = -b / (2 * a);
+        double spread = fabs(root / (2 * a));
+
+        roots_real[p] = degenerate ? NAN : (real ? near : center);
+        roots_imag[p] = degenerate ? NAN : (real ? 0.0 : -spread);
+        roots_real[count + p] = degenerate ? NAN : (real ? far : center);
+        roots_imag[count + p] = degenerate ? NAN : (real ? 0.0 : spread);
+    }
+}
+
+typedef struct {
+    double *monic;
+    double *real;
+    double *imag;
+    double *radius;
+    double *step;
+    double *value_real, *value_imag;
+    double *slope_real, *slope_imag;
+    double *sum_real, *sum_imag;
+    bool *degenerate;
+} AberthWork;
+
+/*
+ * Monic coefficients and starting points on a circle whose radius is the
+ * geometric mean of the root moduli, or the Fujiwara bound when p(0) = 0.
+ */
+static void start_aberth_block(int n, const double *coefficients, size_t count, size_t first, size_t width,
+                               AberthWork *w) {
+    for (size_t p = 0; p < width; p++) {
+        double lead = coefficients[first + p];
+        bool degenerate = lead == 0 || !isfinite(lead);
+        double bound = 0.0;
+
+        for (int k = 1; k <= n; k++) {
+            double c = degenerate ? 0.0 : coefficients[(size_t)k * count + first + p] / lead;
+            w->monic[(size_t)k * POLYNOMIAL_BLOCK + p] = c;
+            degenerate = degenerate || !isfinite(c);
+            double scaled = pow(fabs(c), 1.0 / k);
+            if (scaled > bound) bound = scaled;
+        }
+
+        w->degenerate[p] = degenerate;
+        double mean = pow(fabs(w->monic[(size_t)n * POLYNOMIAL_BLOCK + p]), 1.0 / n);
+        w->radius[p] = degenerate || bound == 0 ? 1.0 : mean > 0 ? mean : bound;
+
+        for (int j = 0; j < n; j++) {
+            double angle = 2 * PI * j / n + 0.4;
+            w->real[(size_t)j * POLYNOMIAL_BLOCK + p] = w->radius[p] * cos(angle);
+            w->imag[(size_t)j * POLYNOMIAL_BLOCK + p] = w->radius[p] * sin(angle);
+        }
+    }
+}
+
+/* One Horner step for p(z) and p'(z) across the block. */
+static void horner_step(size_t width, const double *restrict zr, const double *restrict zi, const double *restrict c,
+                        double *restrict value_real, double *restrict value_imag,
+                        double *restrict slope_real, double *restrict slope_imag) {
+    for (size_t p = 0; p < width; p++) {
+        double vr = value_real[p], vi = value_imag[p];
+        double sr = slope_real[p], si = slope_imag[p];
+        slope_real[p] = sr * zr[p] - si * zi[p] + vr;
+        slope_imag[p] = sr * zi[p] + si * zr[p] + vi;
+        value_real[p] = vr * zr[p] - vi * zi[p] + c[p];
+        value_imag[p] = vr * zi[p] + vi * zr[p];
+    }
+}
+
+/* Adds 1 / (z_j - z_k) across the block. */
+static void add_reciprocal(size_t width, const double *restrict zr, const double *restrict zi,
+                           const double *restrict kr, const double *restrict ki,
+                           double *restrict sum_real, double *restrict sum_imag) {
+    for (size_t p = 0; p < width; p++) {
+        double dx = zr[p] - kr[p];
+        double dy = zi[p] - ki[p];
+        double inverse = 1.0 / (dx * dx + dy * dy);
+        sum_real[p] += dx * inverse;
+        sum_imag[p] -= dy * inverse;
+    }
+}
+
+/*
+ * Aberth correction w = N / (1 - N * sum) with the Newton step N = p(z) / p'(z).
+ * A zero derivative or denominator makes w non-finite; that lane stays put for this sweep.
+ */
+static void apply_correction(size_t width, double *restrict zr, double *restrict zi,
+                             const double *restrict value_real, const double *restrict value_imag,
+                             const double *restrict slope_real, const double *restrict slope_imag,
+                             const double *restrict sum_real, const double *restrict sum_imag,
+                             const double *restrict radius, double *restrict step) {
+    for (size_t p = 0; p < width; p++) {
+        double vr = value_real[p], vi = value_imag[p];
+        double sr = slope_real[p], si = slope_imag[p];
+        double slope_norm = sr * sr + si * si;
+        double nr = (vr * sr + vi * si) / slope_norm;
+        double ni = (vi * sr - vr * si) / slope_norm;
+
+        double dr = 1.0 - (nr * sum_real[p] - ni * sum_imag[p]);
+        double di = -(nr * sum_imag[p] + ni * sum_real[p]);
+        double d_norm = dr * dr + di * di;
+        double step_real = (nr * dr + ni * di) / d_norm;
+        double step_imag = (ni * dr - nr * di) / d_norm;
+
+        bool finite = fabs(step_real) <= DBL_MAX && fabs(step_imag) <= DBL_MAX;
+        step_real = finite ? step_real : 0.0;
+        step_imag = finite ? step_imag : 0.0;
+        zr[p] -= step_real;
+        zi[p] -= step_imag;
+
+        double scale = zr[p] * zr[p] + zi[p] * zi[p] + radius[p] * radius[p];
+        double relative = (step_real * step_real + step_imag * step_imag) / scale;
+        step[p] = relative > step[p] ? relative : step[p];
+    }
+}
+
+/*
+ * Aberth-Ehrlich with Gauss-Seidel updates, one root index at a time. Each
+ * kernel runs over the polynomials of the block, so the arithmetic vectorizes.
+ */
+static void run_aberth_block(int n, size_t width, AberthWork *w) {
+    for (int iteration = 0; iteration < ABERTH_MAX_ITERATIONS; iteration++) {
+        for (size_t p = 0; p < width; p++) {
+            w->step[p] = 0.0;
+        }
+
+        for (int j = 0; j < n; j++) {
+            double *zr = w->real + (size_t)j * POLYNOMIAL_BLOCK;
+            double *zi = w->imag + (size_t)j * POLYNOMIAL_BLOCK;
+
+            for (size_t p = 0; p < width; p++) {
+                w->value_real[p] = 1.0;
+                w->value_imag[p] = 0.0;
+                w->slope_real[p] = 0.0;
+                w->slope_imag[p] = 0.0;
+                w->sum_real[p] = 0.0;
+                w->sum_imag[p] = 0.0;
+            }
+
+            for (int k = 1; k <= n; k++) {
+                horner_step(width, zr, zi, w->monic + (size_t)k * POLYNOMIAL_BLOCK,
+                            w->value_real, w->value_imag, w->slope_real, w->slope_imag);
+            }
+
+            for (int k = 0; k < n; k++) {
+                if (k == j) continue;
+                add_reciprocal(width, zr, zi, w->real + (size_t)k * POLYNOMIAL_BLOCK,
+                               w->imag + (size_t)k * POLYNOMIAL_BLOCK, w->sum_real, w->sum_imag);
+            }
+
+            apply_correction(width, zr, zi, w->value_real, w->value_imag, w->slope_real, w->slope_imag,
+                             w->sum_real, w->sum_imag, w->radius, w->step);
+        }
+
+        bool converged = true;
+        for (size_t p = 0; p < width; p++) {
+            converged = converged && (w->degenerate[p] || w->step[p] <= ABERTH_TOLERANCE * ABERTH_TOLERANCE);
+        }
+        if (converged) {
+            break;
+        }
+    }
+}
+
+static void finish_aberth_block(int n, size_t count, size_t first, size_t width, const AberthWork *w,
+                                double *roots_real, double *roots_imag, PolynomialStatus *statuses) {
+    for (size_t p = 0; p < width; p++) {
+        bool degenerate = w->degenerate[p];
+        statuses[first + p] = degenerate ? POLYNOMIAL_DEGENERATE
+                            : w->step[p] <= ABERTH_TOLERANCE * ABERTH_TOLERANCE ? POLYNOMIAL_SUCCESS
+                            : POLYNOMIAL_NO_CONVERGENCE;
+
+        for (int j = 0; j < n; j++) {
+            roots_real[(size_t)j * count + first + p] = degenerate ? NAN : w->real[(size_t)j * POLYNOMIAL_BLOCK + p];
+            roots_imag[(size_t)j * count + first + p] = degenerate ? NAN : w->imag[(size_t)j * POLYNOMIAL_BLOCK + p];
+        }
+    }
+}
+
+PolynomialStatus solve_polynomial_batch(int degree, const double *coefficients, size_t count,
+                                        double *roots_real, double *roots_imag, PolynomialStatus *statuses) {
+    if (coefficients == NULL || roots_real == NULL || roots_imag == NULL || statuses == NULL ||
+        degree < 1 || degree > POLYNOMIAL_MAX_DEGREE) {
+        return POLYNOMIAL_INVALID_PARAMS;
+    }
+
+    if (degree <= 2) {
+        solve_low_degree(degree, coefficients, count, roots_real, roots_imag, statuses);
+        return POLYNOMIAL_SUCCESS;
+    }
+
+    size_t n = (size_t)degree;
+    size_t lane_doubles = (n + 1) + 2 * n + 8;
+    double *storage = (double*)malloc(lane_doubles * POLYNOMIAL_BLOCK * sizeof(double));
+    bool *degenerate = (bool*)malloc(POLYNOMIAL_BLOCK * sizeof(bool));
+    if (storage == NULL || degenerate == NULL) {
+        free(storage);
+        free(degenerate);
+        return POLYNOMIAL_MEMORY_ERROR;
+    }
+
+    AberthWork work;
+    work.monic = storage;
+    work.real = work.monic + (n + 1) * POLYNOMIAL_BLOCK;
+    work.imag = work.real + n * POLYNOMIAL_BLOCK;
+    work.radius = work.imag + n * POLYNOMIAL_BLOCK;
+    work.step = work.radius + POLYNOMIAL_BLOCK;
+    work.value_real = work.step + POLYNOMIAL_BLOCK;
+    work.value_imag = work.value_real + POLYNOMIAL_BLOCK;
+    work.slope_real = work.value_imag + POLYNOMIAL_BLOCK;
+    work.slope_imag = work.slope_real + POLYNOMIAL_BLOCK;
+    work.sum_real = work.slope_imag + POLYNOMIAL_BLOCK;
+    work.sum_imag = work.sum_real + POLYNOMIAL_BLOCK;
+    work.degenerate = degenerate;
+
+    for (size_t first = 0; first < count; first += POLYNOMIAL_BLOCK) {
+        size_t width = count - first < POLYNOMIAL_BLOCK ? count - first : POLYNOMIAL_BLOCK;
+        start_aberth_block(degree, coefficients, count, first, width, &work);
+        run_aberth_block(degree, width, &work);
+        finish_aberth_block(degree, count, first, width, &work, roots_real, roots_imag, statuses);
+    }
+
+    free(storage);
+    free(degenerate);
+    return POLYNOMIAL_SUCCESS;
+}
+
+PolynomialStatus solve_polynomial(const double *coefficients, int degree, double *roots_real, double *roots_imag) {
+    PolynomialStatus status;
+    PolynomialStatus result = solve_polynomial_batch(degree, coefficients, 1, roots_real, roots_imag, &status);
+    return result == POLYNOMIAL_SUCCESS ? status : result;
+}
+
+void print_polynomial_roots(const double *roots_real, const double *roots_imag, int degree) {
+    if (roots_real == NULL || roots_imag == NULL) return;
+
+    for (int j = 0; j < degree; j++) {
+        double imag = fabs(roots_imag[j]) < 1e-12 * (1 + fabs(roots_real[j])) ? 0.0 : roots_imag[j];
+        if (imag == 0.0) {
+            printf("Root %d: %.6f\n", j + 1, roots_real[j]);
+        } else {
+            printf("Root %d: %.6f %c %.6fi\n", j + 1, roots_real[j], imag < 0 ? '-' : '+', fabs(imag));
+        }
+    }
+}
+
+void print_polynomial_status(PolynomialStatus status) {
+    switch (status) {
+        case POLYNOMIAL_SUCCESS:
+            printf("Polynomial solved successfully");
+            break;
+        case POLYNOMIAL_INVALID_PARAMS:
+            printf("Error: Invalid parameters");
+            break;
+        case POLYNOMIAL_DEGENERATE:
+            printf("Error: Leading coefficient is zero or not finite");
+            break;
+        case POLYNOMIAL_NO_CONVERGENCE:
+            printf("Warning: Roots did not reach full precision");
+            break;
+        case POLYNOMIAL_MEMORY_ERROR:
+            printf("Error: Memory allocation failed");
+            break;
+        default:
+            printf("Unknown status");
+            break;
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef POLYNOMIAL_H
+#define POLYNOMIAL_H
+
+#include <stddef.h>
+
+#define POLYNOMIAL_MAX_DEGREE 64
+
+typedef enum {
+    POLYNOMIAL_SUCCESS = 0,
+    POLYNOMIAL_INVALID_PARAMS = 1,
+    POLYNOMIAL_DEGENERATE = 2,
+    POLYNOMIAL_NO_CONVERGENCE = 3,
+    POLYNOMIAL_MEMORY_ERROR = 4
+} PolynomialStatus;
+
+/*
+ * Coefficients are ordered from the leading term down: c[0] x^n + ... + c[n].
+ * The batch form is structure-of-arrays: coefficient k of polynomial p is
+ * coefficients[k * count + p] and root j is roots_real/imag[j * count + p].
+ */
+PolynomialStatus solve_polynomial(const double *coefficients, int degree, double *roots_real, double *roots_imag);
+PolynomialStatus solve_polynomial_batch(int degree, const double *coefficients, size_t count,
+                                        double *roots_real, double *roots_imag, PolynomialStatus *statuses);
+
+void print_polynomial_roots(const double *roots_real, const double *roots_imag, int degree);
+void print_polynomial_status(PolynomialStatus status);
+
+#endif
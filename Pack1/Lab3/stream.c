@@ -0,0 +1,665 @@
+#include "stream.h"
+#include "operations.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <errno.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define CHUNK_BYTES (1u << 20)
+#define CHUNKS_PER_THREAD 4
+#define MAX_NUMBER_LENGTH 128
+#define MAX_EXACT_MANTISSA (1ULL << 53)
+#define MAX_EXACT_EXPONENT 22
+#define QUADRATIC_ROWS 64
+#define MULTIPLE_ROWS 256
+
+static const double exact_powers_of_ten[MAX_EXACT_EXPONENT + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+typedef struct {
+    const char *data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE mapping;
+#endif
+} MappedFile;
+
+typedef struct {
+    char *data;
+    size_t size;
+    size_t capacity;
+    bool done;
+    StreamStatus status;
+} ChunkOutput;
+
+/* Rows of a chunk waiting for solve_quadratic_permutations_batch. */
+typedef struct {
+    double a[QUADRATIC_ROWS];
+    double b[QUADRATIC_ROWS];
+    double c[QUADRATIC_ROWS];
+    bool valid[QUADRATIC_ROWS];
+    size_t count;
+    PermutationsResult results[QUADRATIC_ROWS];
+} QuadraticRows;
+
+/* num1,num2 rows of a chunk; runs sharing num2 go to check_multiple_batch together. */
+typedef struct {
+    int nums[MULTIPLE_ROWS];
+    int divisors[MULTIPLE_ROWS];
+    bool valid[MULTIPLE_ROWS];
+    size_t count;
+    uint8_t marks[MULTIPLE_ROWS];
+} MultipleRows;
+
+typedef struct {
+    const char *data;
+    size_t size;
+    size_t chunk_count;
+    StreamOperation operation;
+    double epsilon;
+
+    ChunkOutput *slots;
+    size_t window;
+    size_t next_chunk;
+    size_t written;
+    bool stopped;
+
+    pthread_mutex_t lock;
+    pthread_cond_t chunk_ready;
+    pthread_cond_t slot_free;
+} StreamJob;
+
+
+static bool is_blank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+static bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+/*
+ * Decimal mantissas that fit in 53 bits scaled by at most 10^22 are converted exactly with
+ * one multiply or divide (Clinger's fast path); anything else falls back to strtod.
+ */
+bool parse_fast_double(const char *begin, const char *end, double *value, const char **next) {
+    const char *p = begin;
+    while (p < end && is_blank(*p)) p++;
+
+    const char *start = p;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    uint64_t mantissa = 0;
+    int significant = 0;
+    int exponent = 0;
+    bool truncated = false;
+    bool any_digit = false;
+
+    for (; p < end && is_digit(*p); p++) {
+        any_digit = true;
+        if (significant < 19) {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            significant += mantissa != 0;
+        } else {
+            exponent++;
+            truncated = true;
+        }
+    }
+
+    if (p < end && *p == '.') {
+        for (p++; p < end && is_digit(*p); p++) {
+            any_digit = true;
+            if (significant < 19) {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                significant += mantissa != 0;
+                exponent--;
+            } else {
+                truncated = true;
+            }
+        }
+    }
+
+    if (!any_digit) {
+        return false;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char *q = p + 1;
+        bool negative_exponent = false;
+        if (q < end && (*q == '+' || *q == '-')) {
+            negative_exponent = *q == '-';
+            q++;
+        }
+
+        if (q < end && is_digit(*q)) {
+            int scale = 0;
+            for (; q < end && is_digit(*q); q++) {
+                if (scale < 100000) scale = scale * 10 + (*q - '0');
+            }
+            exponent += negative_exponent ? -scale : scale;
+            p = q;
+        }
+    }
+
+    *next = p;
+
+    if (!truncated && mantissa <= MAX_EXACT_MANTISSA &&
+        exponent >= -MAX_EXACT_EXPONENT && exponent <= MAX_EXACT_EXPONENT) {
+        double result = (double)mantissa;
+        result = exponent < 0 ? result / exact_powers_of_ten[-exponent] : result * exact_powers_of_ten[exponent];
+        *value = negative ? -result : result;
+        return true;
+    }
+
+    size_t length = (size_t)(p - start);
+    if (length >= MAX_NUMBER_LENGTH) {
+        return false;
+    }
+
+    char text[MAX_NUMBER_LENGTH];
+    memcpy(text, start, length);
+    text[length] = '\0';
+
+    char *endptr;
+    errno = 0;
+    double result = strtod(text, &endptr);
+    if (endptr != text + length || errno != 0 || isinf(result) || isnan(result)) {
+        return false;
+    }
+
+    *value = result;
+    return true;
+}
+
+static bool parse_fast_int(const char *begin, const char *end, int *value, const char **next) {
+    const char *p = begin;
+    while (p < end && is_blank(*p)) p++;
+
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    if (p == end || !is_digit(*p)) {
+        return false;
+    }
+
+    int64_t result = 0;
+    for (; p < end && is_digit(*p); p++) {
+        result = result * 10 + (*p - '0');
+        if (result > (int64_t)INT32_MAX + negative) {
+            return false;
+        }
+    }
+
+    *value = (int)(negative ? -result : result);
+    *next = p;
+    return true;
+}
+
+/* Parses count comma-separated fields that must fill the whole line. */
+static bool parse_doubles(const char *p, const char *end, double *fields, int count) {
+    for (int i = 0; i < count; i++) {
+        if (!parse_fast_double(p, end, &fields[i], &p)) {
+            return false;
+        }
+        while (p < end && is_blank(*p)) p++;
+        if (i < count - 1) {
+            if (p == end || *p != ',') return false;
+            p++;
+        }
+    }
+    return p == end;
+}
+
+static bool parse_ints(const char *p, const char *end, int *fields, int count) {
+    for (int i = 0; i < count; i++) {
+        if (!parse_fast_int(p, end, &fields[i], &p)) {
+            return false;
+        }
+        while (p < end && is_blank(*p)) p++;
+        if (i < count - 1) {
+            if (p == end || *p != ',') return false;
+            p++;
+        }
+    }
+    return p == end;
+}
+
+
+static bool append_format(ChunkOutput *out, const char *format, ...) {
+    va_list args;
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        size_t available = out->capacity - out->size;
+        char *destination = out->data != NULL ? out->data + out->size : NULL;
+
+        va_start(args, format);
+        int length = vsnprintf(destination, available, format, args);
+        va_end(args);
+
+        if (length < 0) {
+            return false;
+        }
+        if ((size_t)length < available) {
+            out->size += (size_t)length;
+            return true;
+        }
+
+        size_t capacity = out->capacity * 2;
+        if (capacity < out->size + (size_t)length + 1) {
+            capacity = out->size + (size_t)length + 1;
+        }
+        char *data = (char*)realloc(out->data, capacity);
+        if (data == NULL) {
+            return false;
+        }
+        out->data = data;
+        out->capacity = capacity;
+    }
+
+    return false;
+}
+
+/* Emits all six permutations of each row as status,root_count,root1,root2 groups on one line. */
+static bool flush_quadratic_rows(QuadraticRows *rows, double epsilon, ChunkOutput *out) {
+    static const QuadraticSolution no_roots = {0.0, 0.0, 0};
+
+    solve_quadratic_permutations_batch(epsilon, rows->a, rows->b, rows->c, rows->count, rows->results);
+
+    for (size_t i = 0; i < rows->count; i++) {
+        for (int p = 0; p < 6; p++) {
+            QuadraticStatus status = rows->valid[i] ? rows->results[i].statuses[p] : QUADRATIC_INVALID_PARAMS;
+            const QuadraticSolution *solution = rows->valid[i] ? &rows->results[i].solutions[p] : &no_roots;
+            if (!append_format(out, "%d,%d,%.6f,%.6f%c", status, solution->root_count,
+                               solution->root1, solution->root2, p < 5 ? ',' : '\n')) {
+                return false;
+            }
+        }
+    }
+
+    rows->count = 0;
+    return true;
+}
+
+/* Emits status,is_multiple per row, checking each run of valid rows with one divisor as a batch. */
+static bool flush_multiple_rows(MultipleRows *rows, ChunkOutput *out) {
+    for (size_t start = 0; start < rows->count;) {
+        size_t stop = start + 1;
+        MultipleStatus status = MULTIPLE_INVALID_PARAMS;
+        
+        if (rows->valid[start]) {
+            while (stop < rows->count && rows->valid[stop] && rows->divisors[stop] == rows->divisors[start]) stop++;
+            status = check_multiple_batch(rows->nums + start, stop - start, rows->divisors[start], rows->marks + start);
+        }
+        
+        for (size_t i = start; i < stop; i++) {
+            if (!append_format(out, "%d,%d\n", status, status == MULTIPLE_SUCCESS && rows->marks[i])) {
+                return false;
+            }
+        }
+        start = stop;
+    }
+
+    rows->count = 0;
+    return true;
+}
+
+static bool process_row(const char *line, const char *end, StreamOperation operation, double epsilon, ChunkOutput *out) {
+    switch (operation) {
+        case STREAM_QUADRATIC:
+            break;  /* batched by process_chunk */
+        case STREAM_MULTIPLE:
+            break;  /* batched by process_chunk */
+        case STREAM_TRIANGLE: {
+            double fields[3];
+            bool is_right = false;
+            TriangleStatus status = TRIANGLE_INVALID_PARAMS;
+            if (parse_doubles(line, end, fields, 3)) {
+                status = check_right_triangle(epsilon, fields[0], fields[1], fields[2], &is_right);
+            }
+            return append_format(out, "%d,%d\n", status, status == TRIANGLE_SUCCESS && is_right);
+        }
+    }
+    return false;
+}
+
+/* First line start at or after offset; lines belong to the chunk holding their first byte. */
+static size_t chunk_boundary(const char *data, size_t size, size_t offset) {
+    if (offset == 0 || offset >= size) {
+        return offset == 0 ? 0 : size;
+    }
+    if (data[offset - 1] == '\n') {
+        return offset;
+    }
+
+    const char *newline = (const char*)memchr(data + offset, '\n', size - offset);
+    return newline != NULL ? (size_t)(newline - data) + 1 : size;
+}
+
+static StreamStatus process_chunk(const StreamJob *job, size_t chunk, ChunkOutput *out) {
+    size_t begin = chunk_boundary(job->data, job->size, chunk * (size_t)CHUNK_BYTES);
+    size_t finish = chunk_boundary(job->data, job->size, (chunk + 1) * (size_t)CHUNK_BYTES);
+    const char *p = job->data + begin;
+    const char *end = job->data + finish;
+
+    QuadraticRows rows;
+    MultipleRows multiples;
+
+    out->size = 0;
+    rows.count = 0;
+    multiples.count = 0;
+
+    while (p < end) {
+        const char *newline = (const char*)memchr(p, '\n', (size_t)(end - p));
+        const char *line_end = newline != NULL ? newline : end;
+        const char *next = newline != NULL ? newline + 1 : end;
+
+        if (line_end > p && line_end[-1] == '\r') line_end--;
+
+        /* A blank line still gets an output line (invalid params) so output row N matches input row N. */
+        if (job->operation == STREAM_QUADRATIC) {
+            double fields[3] = {0.0, 0.0, 0.0};
+            size_t row = rows.count++;
+            rows.valid[row] = parse_doubles(p, line_end, fields, 3);
+            rows.a[row] = fields[0];
+            rows.b[row] = fields[1];
+            rows.c[row] = fields[2];
+            if (rows.count == QUADRATIC_ROWS && !flush_quadratic_rows(&rows, job->epsilon, out)) {
+                return STREAM_MEMORY_ERROR;
+            }
+        } else if (job->operation == STREAM_MULTIPLE) {
+            int fields[2] = {0, 0};
+            size_t row = multiples.count++;
+            multiples.valid[row] = parse_ints(p, line_end, fields, 2);
+            multiples.nums[row] = fields[0];
+            multiples.divisors[row] = fields[1];
+            if (multiples.count == MULTIPLE_ROWS && !flush_multiple_rows(&multiples, out)) {
+                return STREAM_MEMORY_ERROR;
+            }
+        } else if (!process_row(p, line_end, job->operation, job->epsilon, out)) {
+            return STREAM_MEMORY_ERROR;
+        }
+        p = next;
+    }
+
+    if (rows.count > 0 && !flush_quadratic_rows(&rows, job->epsilon, out)) {
+        return STREAM_MEMORY_ERROR;
+    }
+    if (multiples.count > 0 && !flush_multiple_rows(&multiples, out)) {
+        return STREAM_MEMORY_ERROR;
+    }
+
+    return STREAM_SUCCESS;
+}
+
+
+static void *run_stream_worker(void *arg) {
+    StreamJob *job = (StreamJob*)arg;
+
+    while (true) {
+        pthread_mutex_lock(&job->lock);
+        while (!job->stopped && job->next_chunk < job->chunk_count &&
+               job->next_chunk >= job->written + job->window) {
+            pthread_cond_wait(&job->slot_free, &job->lock);
+        }
+        if (job->stopped || job->next_chunk >= job->chunk_count) {
+            pthread_mutex_unlock(&job->lock);
+            return NULL;
+        }
+        size_t chunk = job->next_chunk++;
+        pthread_mutex_unlock(&job->lock);
+
+        ChunkOutput *slot = &job->slots[chunk % job->window];
+        StreamStatus status = process_chunk(job, chunk, slot);
+
+        pthread_mutex_lock(&job->lock);
+        slot->status = status;
+        slot->done = true;
+        pthread_cond_broadcast(&job->chunk_ready);
+        pthread_mutex_unlock(&job->lock);
+    }
+}
+
+/* Writes finished chunks in input order while the workers fill the window ahead of it. */
+static StreamStatus write_chunks_in_order(StreamJob *job, FILE *output) {
+    StreamStatus result = STREAM_SUCCESS;
+
+    for (size_t chunk = 0; chunk < job->chunk_count && result == STREAM_SUCCESS; chunk++) {
+        ChunkOutput *slot = &job->slots[chunk % job->window];
+
+        pthread_mutex_lock(&job->lock);
+        while (!slot->done) {
+            pthread_cond_wait(&job->chunk_ready, &job->lock);
+        }
+        pthread_mutex_unlock(&job->lock);
+
+        result = slot->status;
+        if (result == STREAM_SUCCESS && fwrite(slot->data, 1, slot->size, output) != slot->size) {
+            result = STREAM_FILE_ERROR;
+        }
+
+        pthread_mutex_lock(&job->lock);
+        slot->done = false;
+        job->written++;
+        if (result != STREAM_SUCCESS) {
+            job->stopped = true;
+        }
+        pthread_cond_broadcast(&job->slot_free);
+        pthread_mutex_unlock(&job->lock);
+    }
+
+    return result;
+}
+
+static StreamStatus run_stream_job(StreamJob *job, int thread_count, FILE *output) {
+    pthread_t *threads = (pthread_t*)malloc((size_t)thread_count * sizeof(pthread_t));
+    if (threads == NULL) {
+        return STREAM_MEMORY_ERROR;
+    }
+
+    int started = 0;
+    while (started < thread_count && pthread_create(&threads[started], NULL, run_stream_worker, job) == 0) {
+        started++;
+    }
+
+    StreamStatus status;
+    if (started == 0) {
+        status = STREAM_THREAD_ERROR;
+    } else {
+        status = write_chunks_in_order(job, output);
+    }
+
+    pthread_mutex_lock(&job->lock);
+    job->stopped = true;
+    pthread_cond_broadcast(&job->slot_free);
+    pthread_mutex_unlock(&job->lock);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    free(threads);
+    return status;
+}
+
+
+static StreamStatus map_file(const char *path, MappedFile *file) {
+    memset(file, 0, sizeof(*file));
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return STREAM_FILE_ERROR;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size)) {
+        CloseHandle(handle);
+        return STREAM_FILE_ERROR;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(handle);
+        return STREAM_SUCCESS;
+    }
+
+    HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(handle);
+    if (!mapping) {
+        return STREAM_FILE_ERROR;
+    }
+
+    const char *data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        return STREAM_FILE_ERROR;
+    }
+
+    file->mapping = mapping;
+    file->data = data;
+    file->size = (size_t)size.QuadPart;
+#else
+    int handle = open(path, O_RDONLY);
+    if (handle < 0) {
+        return STREAM_FILE_ERROR;
+    }
+
+    struct stat info;
+    if (fstat(handle, &info) != 0) {
+        close(handle);
+        return STREAM_FILE_ERROR;
+    }
+    if (info.st_size == 0) {
+        close(handle);
+        return STREAM_SUCCESS;
+    }
+
+    const char *data = (const char*)mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, handle, 0);
+    close(handle);
+    if (data == MAP_FAILED) {
+        return STREAM_FILE_ERROR;
+    }
+
+    file->data = data;
+    file->size = (size_t)info.st_size;
+#endif
+
+    return STREAM_SUCCESS;
+}
+
+static void unmap_file(MappedFile *file) {
+    if (file->data == NULL) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(file->data);
+    CloseHandle(file->mapping);
+#else
+    munmap((void*)file->data, file->size);
+#endif
+
+    memset(file, 0, sizeof(*file));
+}
+
+
+int default_thread_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+StreamStatus process_csv_stream(const char *path, StreamOperation operation, double epsilon, int thread_count, FILE *output) {
+    if (path == NULL || output == NULL || thread_count < 1) {
+        return STREAM_INVALID_PARAMS;
+    }
+
+    MappedFile file;
+    StreamStatus status = map_file(path, &file);
+    if (status != STREAM_SUCCESS || file.size == 0) {
+        return status;
+    }
+
+    StreamJob job;
+    memset(&job, 0, sizeof(job));
+    job.data = file.data;
+    job.size = file.size;
+    job.chunk_count = (file.size + CHUNK_BYTES - 1) / CHUNK_BYTES;
+    job.operation = operation;
+    job.epsilon = epsilon;
+    job.window = (size_t)thread_count * CHUNKS_PER_THREAD;
+    job.slots = (ChunkOutput*)calloc(job.window, sizeof(ChunkOutput));
+
+    if (job.slots == NULL) {
+        unmap_file(&file);
+        return STREAM_MEMORY_ERROR;
+    }
+
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.chunk_ready, NULL);
+    pthread_cond_init(&job.slot_free, NULL);
+
+    status = run_stream_job(&job, thread_count, output);
+    if (status == STREAM_SUCCESS && fflush(output) != 0) {
+        status = STREAM_FILE_ERROR;
+    }
+
+    pthread_cond_destroy(&job.slot_free);
+    pthread_cond_destroy(&job.chunk_ready);
+    pthread_mutex_destroy(&job.lock);
+
+    for (size_t i = 0; i < job.window; i++) {
+        free(job.slots[i].data);
+    }
+    free(job.slots);
+    unmap_file(&file);
+    return status;
+}
+
+void print_stream_status(StreamStatus status) {
+    switch (status) {
+        case STREAM_SUCCESS:
+            printf("Stream processed successfully");
+            break;
+        case STREAM_INVALID_PARAMS:
+            printf("Error: Invalid parameters");
+            break;
+        case STREAM_FILE_ERROR:
+            printf("Error: Cannot read input or write output");
+            break;
+        case STREAM_MEMORY_ERROR:
+            printf("Error: Memory allocation failed");
+            break;
+        case STREAM_THREAD_ERROR:
+            printf("Error: Cannot start worker threads");
+            break;
+        default:
+            printf("Unknown status");
+            break;
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef enum {
+    STREAM_SUCCESS = 0,
+    STREAM_INVALID_PARAMS = 1,
+    STREAM_FILE_ERROR = 2,
+    STREAM_MEMORY_ERROR = 3,
+    STREAM_THREAD_ERROR = 4
+} StreamStatus;
+
+typedef enum {
+    STREAM_QUADRATIC = 0,
+    STREAM_MULTIPLE = 1,
+    STREAM_TRIANGLE = 2
+} StreamOperation;
+
+StreamStatus process_csv_stream(const char *path, StreamOperation operation, double epsilon, int thread_count, FILE *output);
+int default_thread_count(void);
+bool parse_fast_double(const char *begin, const char *end, double *value, const char **next);
+
+void print_stream_status(StreamStatus status);
+
+#endif
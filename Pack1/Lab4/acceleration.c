@@ -0,0 +1,240 @@
+#include "acceleration.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+void accelerator_init(Accelerator *acc, AccelerationMethod method) {
+    memset(acc, 0, sizeof(*acc));
+    acc->method = method;
+    accumulator_init(&acc->partial, SUMMATION_NEUMAIER);
+    accumulator_init(&acc->euler_sum, SUMMATION_NEUMAIER);
+}
+
+
+static int window_size(const Accelerator *acc) {
+    return acc->count < ACCELERATION_ORDER + 1 ? acc->count : ACCELERATION_ORDER + 1;
+}
+
+
+static double aitken_estimate(const Accelerator *acc) {
+    double level[ACCELERATION_ORDER + 1], next[ACCELERATION_ORDER + 1];
+    int length = window_size(acc);
+    memcpy(level, acc->sums + acc->count - length, length * sizeof(double));
+
+    while (length >= 3) {
+        for (int i = 0; i + 2 < length; i++) {
+            double d1 = level[i + 1] - level[i];
+            double d2 = level[i + 2] - level[i + 1];
+            double denominator = d2 - d1;
+            if (denominator == 0) {
+                return level[length - 1];
+            }
+            next[i] = level[i + 2] - d2 * d2 / denominator;
+            if (!isfinite(next[i])) {
+                return level[length - 1];
+            }
+        }
+        length -= 2;
+        memcpy(level, next, length * sizeof(double));
+    }
+    return level[length - 1];
+}
+
+
+static double richardson_estimate(const Accelerator *acc) {
+    double p[ACCELERATION_ORDER + 1], x[ACCELERATION_ORDER + 1];
+    int length = window_size(acc);
+    long long first = acc->total - length + 1;
+
+    for (int i = 0; i < length; i++) {
+        p[i] = acc->sums[acc->count - length + i];
+        x[i] = ldexp(1.0, -(int)(first + i - 1));
+    }
+    for (int m = 1; m < length; m++) {
+        for (int i = 0; i + m < length; i++) {
+            p[i] = (x[i] * p[i + 1] - x[i + m] * p[i]) / (x[i] - x[i + m]);
+        }
+    }
+    return p[0];
+}
+
+
+static double levin_estimate(const Accelerator *acc) {
+    int length = window_size(acc);
+    int k = length - 1;
+    long long first = acc->total - length;
+    double numerator = 0.0, denominator = 0.0;
+    double binomial = 1.0, sign = 1.0;
+
+    for (int i = 0; i <= k; i++) {
+        long long j = first + i;
+        double omega = (j + 1.0) * acc->terms[acc->count - length + i];
+        if (omega == 0 || !isfinite(omega)) {
+            return acc->sums[acc->count - 1];
+        }
+        double weight = sign * binomial * pow((j + 1.0) / (first + k + 1.0), k - 1) / omega;
+        numerator += weight * acc->sums[acc->count - length + i];
+        denominator += weight;
+        binomial = binomial * (k - i) / (i + 1);
+        sign = -sign;
+    }
+
+    double estimate = numerator / denominator;
+    return isfinite(estimate) ? estimate : acc->sums[acc->count - 1];
+}
+
+
+static void euler_add(Accelerator *acc, double term) {
+    if (acc->euler_terms == 0) {
+        acc->euler[0] = term;
+        accumulator_add(&acc->euler_sum, 0.5 * term);
+        acc->euler_terms = 1;
+        return;
+    }
+    if (acc->euler_terms == ACCELERATION_MAX_TERMS) {
+        accumulator_add(&acc->euler_sum, term);
+        return;
+    }
+
+    double previous = acc->euler[0];
+    acc->euler[0] = term;
+    for (int j = 1; j < acc->euler_terms; j++) {
+        double saved = acc->euler[j];
+        acc->euler[j] = 0.5 * (acc->euler[j - 1] + previous);
+        previous = saved;
+    }
+
+    int n = acc->euler_terms;
+    acc->euler[n] = 0.5 * (acc->euler[n - 1] + previous);
+    if (fabs(acc->euler[n]) <= fabs(acc->euler[n - 1])) {
+        accumulator_add(&acc->euler_sum, 0.5 * acc->euler[n]);
+        acc->euler_terms++;
+    } else {
+        accumulator_add(&acc->euler_sum, acc->euler[n]);
+    }
+}
+
+
+static double accelerator_push(Accelerator *acc, double term, double sum) {
+    if (acc->count == ACCELERATION_MAX_TERMS) {
+        int keep = ACCELERATION_MAX_TERMS / 2;
+        memmove(acc->sums, acc->sums + acc->count - keep, keep * sizeof(double));
+        memmove(acc->terms, acc->terms + acc->count - keep, keep * sizeof(double));
+        acc->count = keep;
+    }
+    acc->sums[acc->count] = sum;
+    acc->terms[acc->count] = term;
+    acc->count++;
+    acc->total++;
+
+    switch (acc->method) {
+        case ACCELERATION_AITKEN:
+            acc->estimate = aitken_estimate(acc);
+            break;
+        case ACCELERATION_RICHARDSON:
+            acc->estimate = richardson_estimate(acc);
+            break;
+        case ACCELERATION_EULER:
+            euler_add(acc, term);
+            acc->estimate = accumulator_result(&acc->euler_sum);
+            break;
+        case ACCELERATION_LEVIN:
+            acc->estimate = levin_estimate(acc);
+            break;
+        default:
+            acc->estimate = sum;
+            break;
+    }
+    return acc->estimate;
+}
+
+
+double accelerator_add_term(Accelerator *acc, double term) {
+    accumulator_add(&acc->partial, term);
+    return accelerator_push(acc, term, accumulator_result(&acc->partial));
+}
+
+
+double accelerator_add_value(Accelerator *acc, double value) {
+    double term = acc->count > 0 ? value - acc->sums[acc->count - 1] : value;
+    return accelerator_push(acc, term, value);
+}
+
+
+void convergence_init(ConvergenceState *state, TermGenerator generator, void *context,
+                      AccelerationMethod method, int max_terms, bool series) {
+    memset(state, 0, sizeof(*state));
+    state->generator = generator;
+    state->context = context;
+    state->series = series;
+    state->max_terms = max_terms;
+    accelerator_init(&state->acc, method);
+    state->differences[0] = INFINITY;
+    state->differences[1] = INFINITY;
+}
+
+
+static bool converged(const ConvergenceState *state, double eps) {
+    return state->differences[0] <= eps && state->differences[1] <= eps;
+}
+
+
+CalcStatus convergence_run(ConvergenceState *state, double eps, double *result) {
+    if (state == NULL || state->generator == NULL || result == NULL || eps <= 0 || state->max_terms < 2) {
+        return ERROR_INVALID_INPUT;
+    }
+    if (state->failed) return ERROR_DIVERGENCE;
+    if (converged(state, eps)) {
+        *result = state->estimate;
+        return SUCCESS;
+    }
+
+    while (state->n < state->max_terms) {
+        state->n++;
+        double x = state->generator(state->n, state->context);
+        double estimate = state->series ? accelerator_add_term(&state->acc, x) : accelerator_add_value(&state->acc, x);
+        if (!isfinite(estimate)) {
+            state->failed = true;
+            return ERROR_DIVERGENCE;
+        }
+
+        if (state->n > 1) {
+            state->differences[1] = state->differences[0];
+            state->differences[0] = fabs(estimate - state->estimate);
+        }
+        state->last = x;
+        state->estimate = estimate;
+
+        if (converged(state, eps)) {
+            *result = estimate;
+            return SUCCESS;
+        }
+    }
+
+    *result = state->estimate;
+    return ERROR_DIVERGENCE;
+}
+
+
+static CalcStatus accelerate(TermGenerator generator, void *context, AccelerationMethod method,
+                             double eps, int max_terms, bool series, double *result) {
+    if (generator == NULL || result == NULL || eps <= 0 || max_terms < 2) return ERROR_INVALID_INPUT;
+
+    ConvergenceState state;
+    convergence_init(&state, generator, context, method, max_terms, series);
+    return convergence_run(&state, eps, result);
+}
+
+
+CalcStatus accelerate_series(TermGenerator term, void *context, AccelerationMethod method,
+                             double eps, int max_terms, double *result) {
+    return accelerate(term, context, method, eps, max_terms, true, result);
+}
+
+
+CalcStatus accelerate_limit(TermGenerator element, void *context, AccelerationMethod method,
+                            double eps, int max_terms, double *result) {
+    return accelerate(element, context, method, eps, max_terms, false, result);
+}
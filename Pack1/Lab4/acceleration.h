@@ -0,0 +1,66 @@
+#ifndef ACCELERATION_H
+#define ACCELERATION_H
+
+#include "constants_calc.h"
+#include "summation.h"
+
+#define ACCELERATION_MAX_TERMS 64
+#define ACCELERATION_ORDER 12
+
+typedef enum {
+    ACCELERATION_NONE,
+    ACCELERATION_AITKEN,
+    ACCELERATION_RICHARDSON,
+    ACCELERATION_EULER,
+    ACCELERATION_LEVIN
+} AccelerationMethod;
+
+// Генератор вызывается по порядку с n = 1, 2, 3, ... и может хранить состояние в context.
+// Для ACCELERATION_RICHARDSON n-й элемент берётся в точке m = 2^(n-1), погрешность - ряд по степеням 1/m
+typedef double (*TermGenerator)(long long n, void *context);
+
+typedef struct {
+    AccelerationMethod method;
+    long long total;
+    int count;
+    double sums[ACCELERATION_MAX_TERMS];
+    double terms[ACCELERATION_MAX_TERMS];
+    double euler[ACCELERATION_MAX_TERMS + 1];
+    int euler_terms;
+    Accumulator euler_sum;
+    Accumulator partial;
+    double estimate;
+} Accelerator;
+
+// Состояние сходимости, которое можно продолжить с меньшим eps.
+// differences - модули двух последних разностей оценок, n - число обработанных элементов
+typedef struct {
+    TermGenerator generator;
+    void *context;
+    bool series;
+    int max_terms;
+    Accelerator acc;
+    long long n;
+    double last;
+    double estimate;
+    double differences[2];
+    bool failed;
+} ConvergenceState;
+
+// Пошаговое ускорение: очередной член ряда или очередной элемент последовательности
+void accelerator_init(Accelerator *acc, AccelerationMethod method);
+double accelerator_add_term(Accelerator *acc, double term);
+double accelerator_add_value(Accelerator *acc, double value);
+
+// Суммирование ряда и предел последовательности до совпадения двух оценок с точностью eps
+CalcStatus accelerate_series(TermGenerator term, void *context, AccelerationMethod method,
+                             double eps, int max_terms, double *result);
+CalcStatus accelerate_limit(TermGenerator element, void *context, AccelerationMethod method,
+                            double eps, int max_terms, double *result);
+
+// Продолжение с места предыдущей остановки: при уменьшении eps результат тот же, что у запуска с нуля
+void convergence_init(ConvergenceState *state, TermGenerator generator, void *context,
+                      AccelerationMethod method, int max_terms, bool series);
+CalcStatus convergence_run(ConvergenceState *state, double eps, double *result);
+
+#endif
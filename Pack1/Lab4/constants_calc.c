@@ -1,11 +1,201 @@
 #include "constants_calc.h"
+#include "acceleration.h"
+#include "summation.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
 #include <ctype.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 
 #define M_PI 3.14159265358979323846
+#define RICHARDSON_LEVELS 24
+#define MAX_THREADS 16
+#define PARALLEL_MIN_BLOCK (1LL << 18)
+#define TERM_BUFFER 256
+#define GAMMA_SIEVE_LIMIT 100000
+#define GAMMA_SIEVE_MAX (1 << 27)
+#define GAMMA_SIEVE_SEGMENT (1 << 16)
+#define MERTENS_DUSART_MIN 2278383
+
+
+typedef struct {
+    long long m;
+    double value;
+} RunningState;
+
+typedef struct {
+    long long m;
+    Accumulator sum;
+} HarmonicState;
+
+// Сумма членов с номерами first..last
+typedef double (*BlockSum)(long long first, long long last);
+
+typedef struct {
+    long long first;
+    long long last;
+    double value;
+} SumChunk;
+
+// Куски блока разбираются вызывающим потоком и выделенными ему помощниками
+typedef struct {
+    BlockSum sum;
+    SumChunk chunks[MAX_THREADS];
+    int count;
+    int next;
+    pthread_mutex_t lock;
+} ChunkQueue;
+
+// Простые одного сегмента решета: произведение (p - 1) / p, число простых и множитель последнего из них
+typedef struct {
+    double product;
+    double last_term;
+    long long count;
+} SieveSegment;
+
+// Сегменты (low, limit] по GAMMA_SIEVE_SEGMENT чисел разбираются так же, как куски ChunkQueue
+typedef struct {
+    const int *primes;
+    size_t prime_count;
+    long long low;
+    long long limit;
+    SieveSegment *segments;
+    int count;
+    int next;
+    pthread_mutex_t lock;
+} SieveQueue;
+
+typedef union {
+    RunningState running;
+    HarmonicState harmonic;
+    double value;
+} GeneratorContext;
+
+// Состояние сходимости вместе с контекстом генератора, на который оно ссылается
+typedef struct {
+    ConvergenceState convergence;
+    GeneratorContext context;
+} ResumableRun;
+
+typedef struct {
+    ComputeFunction compute;
+    ResumableFunction resume;
+    ComputeState *state;
+    double eps;
+    double result;
+    CalcStatus status;
+} ComputeJob;
+
+typedef struct {
+    ComputeJob *jobs;
+    int count;
+    int next;
+    pthread_mutex_t lock;
+} JobQueue;
+
+
+static int thread_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    long n = (long)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (n < 1) return 1;
+    return n > MAX_THREADS ? MAX_THREADS : (int)n;
+}
+
+
+// Общий бюджет потоков: вместе с вызывающим одновременно работают не больше thread_count()
+static pthread_mutex_t budget_lock = PTHREAD_MUTEX_INITIALIZER;
+static int busy_threads = 1;
+
+static int reserve_threads(int wanted) {
+    pthread_mutex_lock(&budget_lock);
+    int available = thread_count() - busy_threads;
+    int granted = wanted < available ? wanted : available;
+    if (granted < 0) granted = 0;
+    busy_threads += granted;
+    pthread_mutex_unlock(&budget_lock);
+    return granted;
+}
+
+
+static void release_threads(int count) {
+    pthread_mutex_lock(&budget_lock);
+    busy_threads -= count;
+    pthread_mutex_unlock(&budget_lock);
+}
+
+
+static void claim_thread(void) {
+    pthread_mutex_lock(&budget_lock);
+    busy_threads++;
+    pthread_mutex_unlock(&budget_lock);
+}
+
+
+static void *run_sum_chunks(void *arg) {
+    ChunkQueue *queue = (ChunkQueue*)arg;
+    for (;;) {
+        pthread_mutex_lock(&queue->lock);
+        int index = queue->next++;
+        pthread_mutex_unlock(&queue->lock);
+        if (index >= queue->count) break;
+
+        SumChunk *chunk = &queue->chunks[index];
+        chunk->value = queue->sum(chunk->first, chunk->last);
+    }
+    return NULL;
+}
+
+
+// Длинный блок всегда делится на thread_count() кусков, их разбирают свободные по бюджету потоки.
+// Разбиение и порядок сложения не зависят от числа помощников, поэтому результат тоже
+static double parallel_block_sum(BlockSum sum, long long first, long long last) {
+    int parts = thread_count();
+    long long length = last - first + 1;
+    if (parts < 2 || length < PARALLEL_MIN_BLOCK) return sum(first, last);
+
+    ChunkQueue queue;
+    queue.sum = sum;
+    queue.count = parts;
+    queue.next = 0;
+    pthread_mutex_init(&queue.lock, NULL);
+    for (int i = 0; i < parts; i++) {
+        queue.chunks[i].first = first + length * i / parts;
+        queue.chunks[i].last = first + length * (i + 1) / parts - 1;
+        queue.chunks[i].value = 0.0;
+    }
+
+    int helpers = reserve_threads(parts - 1);
+    pthread_t ids[MAX_THREADS];
+    bool started[MAX_THREADS] = {false};
+    for (int i = 0; i < helpers; i++) {
+        started[i] = pthread_create(&ids[i], NULL, run_sum_chunks, &queue) == 0;
+    }
+    run_sum_chunks(&queue);
+    for (int i = 0; i < helpers; i++) {
+        if (started[i]) pthread_join(ids[i], NULL);
+    }
+    release_threads(helpers);
+    pthread_mutex_destroy(&queue.lock);
+
+    Accumulator total;
+    accumulator_init(&total, SUMMATION_DOUBLE_DOUBLE);
+    for (int i = 0; i < parts; i++) {
+        accumulator_add(&total, queue.chunks[i].value);
+    }
+    return accumulator_result(&total);
+}
 
 
 bool parse_double(const char *str, double *value) {
@@ -18,33 +208,87 @@ bool parse_double(const char *str, double *value) {
 }
 
 
+void compute_state_init(ComputeState *state) {
+    memset(state, 0, sizeof(*state));
+}
+
+
+void compute_state_free(ComputeState *state) {
+    free(state->primes);
+    free(state->engine);
+    compute_state_init(state);
+}
+
+
+// Первый вызов создаёт состояние сходимости с начальным контекстом, следующие продолжают его
+static CalcStatus resume_convergence(ComputeState *state, TermGenerator generator, const GeneratorContext *initial,
+                                     AccelerationMethod method, int max_terms, bool series,
+                                     double eps, double *result) {
+    if (state == NULL || result == NULL || eps <= 0) return ERROR_INVALID_INPUT;
+
+    ResumableRun *run = (ResumableRun*)state->engine;
+    if (run == NULL) {
+        run = (ResumableRun*)calloc(1, sizeof(ResumableRun));
+        if (!run) return ERROR_MEMORY;
+        if (initial) run->context = *initial;
+        convergence_init(&run->convergence, generator, &run->context, method, max_terms, series);
+        state->engine = run;
+    }
+
+    CalcStatus status = convergence_run(&run->convergence, eps, result);
+
+    const Accelerator *acc = &run->convergence.acc;
+    state->n = run->convergence.n;
+    state->estimate = run->convergence.estimate;
+    if (acc->count > 0) {
+        state->partial_sum = acc->sums[acc->count - 1];
+        state->last_term = acc->terms[acc->count - 1];
+    }
+    return status;
+}
+
+
+static CalcStatus run_once(ResumableFunction resume, double eps, double *result) {
+    ComputeState state;
+    compute_state_init(&state);
+    CalcStatus status = resume(&state, eps, result);
+    compute_state_free(&state);
+    return status;
+}
+
+
+static double e_limit_element(long long n, void *context) {
+    (void)context;
+    double m = ldexp(1.0, (int)(n - 1));
+    return pow(1.0 + 1.0 / m, m);
+}
+
+
+CalcStatus compute_e_limit_resume(ComputeState *state, double eps, double *result) {
+    return resume_convergence(state, e_limit_element, NULL, ACCELERATION_RICHARDSON, RICHARDSON_LEVELS, false, eps, result);
+}
+
+
 CalcStatus compute_e_limit(double eps, double *result) {
-    if (eps <= 0) return ERROR_INVALID_INPUT;
-    long long n = 1;
-    double prev, curr = pow(1.0 + 1.0 / n, n);
-    do {
-        prev = curr;
-        n *= 2;
-        curr = pow(1.0 + 1.0 / n, n);
-        if (n > 1e12) return ERROR_DIVERGENCE;
-    } while (fabs(curr - prev) > eps);
-    *result = curr;
-    return SUCCESS;
+    return run_once(compute_e_limit_resume, eps, result);
+}
+
+
+static double e_series_term(long long n, void *context) {
+    double *term = (double*)context;
+    if (n > 1) *term /= n - 1;
+    return *term;
+}
+
+
+CalcStatus compute_e_series_resume(ComputeState *state, double eps, double *result) {
+    GeneratorContext initial = {.value = 1.0};
+    return resume_convergence(state, e_series_term, &initial, ACCELERATION_NONE, 1000000, true, eps, result);
 }
 
 
 CalcStatus compute_e_series(double eps, double *result) {
-    if (eps <= 0) return ERROR_INVALID_INPUT;
-    double sum = 1.0, term = 1.0;
-    int n = 1;
-    while (fabs(term) > eps) {
-        term /= n;
-        sum += term;
-        n++;
-        if (n > 1000000) return ERROR_DIVERGENCE;
-    }
-    *result = sum;
-    return SUCCESS;
+    return run_once(compute_e_series_resume, eps, result);
 }
 
 
@@ -65,37 +309,41 @@ CalcStatus solve_ln_x_eq_1(double eps, double *result) {
 }
 
 
+static double pi_limit_element(long long n, void *context) {
+    RunningState *state = (RunningState*)context;
+    for (long long end = 1LL << (n - 1); state->m < end; ) {
+        state->m++;
+        double k = (double)state->m;
+        state->value *= (4.0 * k * k) / (4.0 * k * k - 1.0);
+    }
+    return 2.0 * state->value;
+}
+
+
+CalcStatus compute_pi_limit_resume(ComputeState *state, double eps, double *result) {
+    GeneratorContext initial = {.running = {0, 1.0}};
+    return resume_convergence(state, pi_limit_element, &initial, ACCELERATION_RICHARDSON, RICHARDSON_LEVELS, false, eps, result);
+}
+
+
 CalcStatus compute_pi_limit(double eps, double *result) {
-    if (eps <= 0) return ERROR_INVALID_INPUT;
-    double product = 1.0;
-    double prev_product = 0.0;
-    int n = 1;
-    do {
-        prev_product = product;
-        double term = (4.0 * n * n) / (4.0 * n * n - 1.0);
-        product *= term;
-        n++;
-        if (n > 5000000) return ERROR_DIVERGENCE;
-    } while (fabs(2.0 * product - 2.0 * prev_product) > eps);
-    *result = 2.0 * product;
-    return SUCCESS;
+    return run_once(compute_pi_limit_resume, eps, result);
+}
+
+
+static double pi_series_term(long long n, void *context) {
+    (void)context;
+    return 4.0 * ((n % 2 == 1) ? 1.0 : -1.0) / (2.0 * n - 1.0);
+}
+
+
+CalcStatus compute_pi_series_resume(ComputeState *state, double eps, double *result) {
+    return resume_convergence(state, pi_series_term, NULL, ACCELERATION_EULER, ACCELERATION_MAX_TERMS, true, eps, result);
 }
 
 
 CalcStatus compute_pi_series(double eps, double *result) {
-    if (eps <= 0) return ERROR_INVALID_INPUT;
-    double sum = 0.0;
-    double prev_sum;
-    int n = 1;
-    do {
-        prev_sum = sum;
-        double term = 4.0 * ((n % 2 == 1) ? 1.0 : -1.0) / (2.0 * n - 1.0);
-        sum += term;
-        n++;
-        if (n > 10000000) return ERROR_DIVERGENCE;
-    } while (fabs(sum - prev_sum) > eps);
-    *result = sum;
-    return SUCCESS;
+    return run_once(compute_pi_series_resume, eps, result);
 }
 
 
@@ -160,35 +408,36 @@ CalcStatus solve_cos_x_eq_minus_1(double eps, double *result) {
 }
 
 
+static double ln2_limit_element(long long n, void *context) {
+    (void)context;
+    double m = ldexp(1.0, (int)(n - 1));
+    return m * (pow(2.0, 1.0 / m) - 1.0);
+}
+
+
+CalcStatus compute_ln2_limit_resume(ComputeState *state, double eps, double *result) {
+    return resume_convergence(state, ln2_limit_element, NULL, ACCELERATION_RICHARDSON, RICHARDSON_LEVELS, false, eps, result);
+}
+
+
 CalcStatus compute_ln2_limit(double eps, double *result) {
-    if (eps <= 0) return ERROR_INVALID_INPUT;
-    double prev = 0.0, curr = 0.0;
-    int n = 1;
-    do {
-        prev = curr;
-        curr = n * (pow(2.0, 1.0 / n) - 1.0);
-        n++;
-        if (n > 1000000) return ERROR_DIVERGENCE;
-    } while (fabs(curr - prev) > eps);
-    *result = curr;
-    return SUCCESS;
+    return run_once(compute_ln2_limit_resume, eps, result);
+}
+
+
+static double ln2_series_term(long long n, void *context) {
+    (void)context;
+    return ((n % 2 == 1) ? 1.0 : -1.0) / n;
+}
+
+
+CalcStatus compute_ln2_series_resume(ComputeState *state, double eps, double *result) {
+    return resume_convergence(state, ln2_series_term, NULL, ACCELERATION_LEVIN, ACCELERATION_MAX_TERMS, true, eps, result);
 }
 
 
 CalcStatus compute_ln2_series(double eps, double *result) {
-    if (eps <= 0) return ERROR_INVALID_INPUT;
-    double sum = 0.0;
-    double prev_sum;
-    int n = 1;
-    do {
-        prev_sum = sum;
-        double term = ((n % 2 == 1) ? 1.0 : -1.0) / n;
-        sum += term;
-        n++;
-        if (n > 10000000) return ERROR_DIVERGENCE;
-    } while (fabs(sum - prev_sum) > eps);
-    *result = sum;
-    return SUCCESS;
+    return run_once(compute_ln2_series_resume, eps, result);
 }
 
 
@@ -222,35 +471,40 @@ CalcStatus solve_exp_x_eq_2(double eps, double *result) {
 }
 
 
+static double sqrt2_limit_element(long long n, void *context) {
+    (void)n;
+    double *x = (double*)context;
+    *x = *x - *x * *x / 2.0 + 1.0;
+    return *x;
+}
+
+
+CalcStatus compute_sqrt2_limit_resume(ComputeState *state, double eps, double *result) {
+    GeneratorContext initial = {.value = -0.5};
+    return resume_convergence(state, sqrt2_limit_element, &initial, ACCELERATION_AITKEN, 10000, false, eps, result);
+}
+
+
 CalcStatus compute_sqrt2_limit(double eps, double *result) {
-    if (eps <= 0) return ERROR_INVALID_INPUT;
-    double x = -0.5;
-    double prev;
-    int iter = 0;
-    do {
-        prev = x;
-        x = x - x * x / 2.0 + 1.0;
-        iter++;
-        if (iter > 10000) return ERROR_NON_CONVERGENCE;
-    } while (fabs(x - prev) > eps);
-    *result = x;
-    return SUCCESS;
+    return run_once(compute_sqrt2_limit_resume, eps, result);
+}
+
+
+static double sqrt2_product_element(long long n, void *context) {
+    double *prod = (double*)context;
+    *prod *= pow(2.0, pow(2.0, -(double)(n + 1)));
+    return *prod;
+}
+
+
+CalcStatus compute_sqrt2_product_resume(ComputeState *state, double eps, double *result) {
+    GeneratorContext initial = {.value = 1.0};
+    return resume_convergence(state, sqrt2_product_element, &initial, ACCELERATION_AITKEN, 10000, false, eps, result);
 }
 
 
 CalcStatus compute_sqrt2_product(double eps, double *result) {
-    if (eps <= 0) return ERROR_INVALID_INPUT;
-    double prod = 1.0;
-    double prev;
-    int k = 2;
-    do {
-        prev = prod;
-        prod *= pow(2.0, pow(2.0, -k));
-        k++;
-        if (k > 10000) return ERROR_DIVERGENCE;
-    } while (fabs(prod - prev) > eps);
-    *result = prod;
-    return SUCCESS;
+    return run_once(compute_sqrt2_product_resume, eps, result);
 }
 
 
@@ -284,73 +538,307 @@ CalcStatus solve_x_squared_eq_2(double eps, double *result) {
 }
 
 
+// Члены блока считаются пачками по TERM_BUFFER и складываются с компенсацией
+static double harmonic_block(long long first, long long last) {
+    double terms[TERM_BUFFER];
+    Accumulator block;
+    accumulator_init(&block, SUMMATION_NEUMAIER);
+    for (long long k = first; k <= last; k += TERM_BUFFER) {
+        int count = last - k + 1 < TERM_BUFFER ? (int)(last - k + 1) : TERM_BUFFER;
+        double base = (double)k;
+        for (int i = 0; i < count; i++) {
+            terms[i] = 1.0 / (base + i);
+        }
+        accumulator_add_array(&block, terms, count);
+    }
+    return accumulator_result(&block);
+}
+
+
+static double gamma_limit_element(long long n, void *context) {
+    HarmonicState *state = (HarmonicState*)context;
+    long long end = 1LL << (n - 1);
+    if (state->m < end) {
+        accumulator_add(&state->sum, parallel_block_sum(harmonic_block, state->m + 1, end));
+        state->m = end;
+    }
+    return accumulator_result(&state->sum) - log((double)state->m);
+}
+
+
+CalcStatus compute_gamma_limit_resume(ComputeState *state, double eps, double *result) {
+    GeneratorContext initial;
+    initial.harmonic.m = 0;
+    accumulator_init(&initial.harmonic.sum, SUMMATION_DOUBLE_DOUBLE);
+    return resume_convergence(state, gamma_limit_element, &initial, ACCELERATION_RICHARDSON, RICHARDSON_LEVELS, false, eps, result);
+}
+
+
 CalcStatus compute_gamma_limit(double eps, double *result) {
-    if (eps <= 0) return ERROR_INVALID_INPUT;
-    double H_n = 1.0;
-    double prev = 0.0, curr = 1.0 - log(1.0);
-    int n = 1;
-    do {
-        prev = curr;
-        n++;
-        H_n += 1.0 / n;
-        curr = H_n - log(n);
-        if (n > 10000000) return ERROR_DIVERGENCE;
-    } while (fabs(curr - prev) > eps);
-    *result = curr;
-    return SUCCESS;
+    return run_once(compute_gamma_limit_resume, eps, result);
+}
+
+
+static double gamma_series_terms(long long first, long long last) {
+    double terms[TERM_BUFFER];
+    Accumulator block;
+    accumulator_init(&block, SUMMATION_NEUMAIER);
+    for (long long k = first; k <= last; k += TERM_BUFFER) {
+        int count = last - k + 1 < TERM_BUFFER ? (int)(last - k + 1) : TERM_BUFFER;
+        double base = (double)k;
+        for (int i = 0; i < count; i++) {
+            double x = 1.0 / (base + i);
+            terms[i] = x - log1p(x);
+        }
+        accumulator_add_array(&block, terms, count);
+    }
+    return accumulator_result(&block);
+}
+
+
+static double gamma_series_block(long long n, void *context) {
+    RunningState *state = (RunningState*)context;
+    long long end = 1LL << (n - 1);
+    if (state->m >= end) return 0.0;
+    double block = parallel_block_sum(gamma_series_terms, state->m + 1, end);
+    state->m = end;
+    return block;
+}
+
+
+CalcStatus compute_gamma_series_resume(ComputeState *state, double eps, double *result) {
+    GeneratorContext initial = {.running = {0, 0.0}};
+    return resume_convergence(state, gamma_series_block, &initial, ACCELERATION_RICHARDSON, RICHARDSON_LEVELS, true, eps, result);
 }
 
 
 CalcStatus compute_gamma_series(double eps, double *result) {
-    if (eps <= 0) return ERROR_INVALID_INPUT;
-    double sum = 0.0;
-    double prev_sum;
-    int n = 1;
-    do {
-        prev_sum = sum;
-        sum += (1.0 / n - log(1.0 + 1.0 / n));
-        n++;
-        if (n > 10000000) return ERROR_DIVERGENCE;
-    } while (fabs(sum - prev_sum) > eps);
-    *result = sum;
+    return run_once(compute_gamma_series_resume, eps, result);
+}
+
+
+// Простые до limit (limit не больше sqrt(GAMMA_SIEVE_MAX)) заново в state->primes
+static CalcStatus sieve_base_primes(ComputeState *state, int limit) {
+    char *composite = calloc(limit + 1, sizeof(char));
+    int *primes = (int*)malloc((limit / 2 + 1) * sizeof(int));
+    if (!composite || !primes) {
+        free(composite);
+        free(primes);
+        return ERROR_MEMORY;
+    }
+
+    size_t count = 0;
+    for (int p = 2; p <= limit; p++) {
+        if (composite[p]) continue;
+        primes[count++] = p;
+        for (int i = p * p; i <= limit; i += p) composite[i] = 1;
+    }
+
+    free(composite);
+    free(state->primes);
+    state->primes = primes;
+    state->prime_count = count;
+    return SUCCESS;
+}
+
+
+static void sieve_segment(const SieveQueue *queue, int index, char *segment) {
+    long long low = queue->low + (long long)index * GAMMA_SIEVE_SEGMENT;
+    long long high = low + GAMMA_SIEVE_SEGMENT - 1 < queue->limit ? low + GAMMA_SIEVE_SEGMENT - 1 : queue->limit;
+    memset(segment, 0, (size_t)(high - low + 1));
+
+    for (size_t k = 0; k < queue->prime_count; k++) {
+        long long p = queue->primes[k];
+        if (p * p > high) break;
+        long long first = (low + p - 1) / p * p;
+        if (first < p * p) first = p * p;
+        for (long long i = first; i <= high; i += p) segment[i - low] = 1;
+    }
+
+    SieveSegment *result = &queue->segments[index];
+    result->product = 1.0;
+    result->last_term = 1.0;
+    result->count = 0;
+    for (long long i = low; i <= high; i++) {
+        if (segment[i - low]) continue;
+        result->last_term = (i - 1.0) / i;
+        result->product *= result->last_term;
+        result->count++;
+    }
+}
+
+
+static void sieve_segments(SieveQueue *queue, char *segment) {
+    for (;;) {
+        pthread_mutex_lock(&queue->lock);
+        int index = queue->next++;
+        pthread_mutex_unlock(&queue->lock);
+        if (index >= queue->count) break;
+
+        sieve_segment(queue, index, segment);
+    }
+}
+
+
+// Помощнику нужен свой буфер сегмента; без памяти он просто не берёт сегменты
+static void *run_sieve_segments(void *arg) {
+    char *segment = malloc(GAMMA_SIEVE_SEGMENT);
+    if (segment) {
+        sieve_segments((SieveQueue*)arg, segment);
+        free(segment);
+    }
+    return NULL;
+}
+
+
+// Сегментное решето на (sieve_limit, limit]: хватает простых до sqrt(limit) из state->primes,
+// произведение (p - 1) / p по новым простым продолжает state->partial_sum, state->n - число простых.
+// Сегменты разбирают вызывающий поток и помощники по бюджету; произведения сегментов
+// перемножаются по порядку, поэтому результат не зависит от числа помощников
+static CalcStatus extend_sieve(ComputeState *state, int limit) {
+    int root = (int)sqrt((double)limit);
+    while ((long long)(root + 1) * (root + 1) <= limit) root++;
+    if (state->prime_count == 0 || state->primes[state->prime_count - 1] < root) {
+        CalcStatus status = sieve_base_primes(state, root);
+        if (status != SUCCESS) return status;
+    }
+
+    if (state->sieve_limit < 2) {
+        state->partial_sum = 1.0;
+        state->sieve_limit = 1;
+    }
+    if (state->sieve_limit >= limit) return SUCCESS;
+
+    SieveQueue queue;
+    queue.primes = state->primes;
+    queue.prime_count = state->prime_count;
+    queue.low = state->sieve_limit + 1;
+    queue.limit = limit;
+    queue.count = (int)((queue.limit - queue.low) / GAMMA_SIEVE_SEGMENT + 1);
+    queue.next = 0;
+    queue.segments = (SieveSegment*)malloc((size_t)queue.count * sizeof(SieveSegment));
+    char *segment = malloc(GAMMA_SIEVE_SEGMENT);
+    if (!queue.segments || !segment) {
+        free(queue.segments);
+        free(segment);
+        return ERROR_MEMORY;
+    }
+    pthread_mutex_init(&queue.lock, NULL);
+
+    int parts = thread_count() < queue.count ? thread_count() : queue.count;
+    int helpers = reserve_threads(parts - 1);
+    pthread_t ids[MAX_THREADS];
+    bool started[MAX_THREADS] = {false};
+    for (int i = 0; i < helpers; i++) {
+        started[i] = pthread_create(&ids[i], NULL, run_sieve_segments, &queue) == 0;
+    }
+    sieve_segments(&queue, segment);
+    for (int i = 0; i < helpers; i++) {
+        if (started[i]) pthread_join(ids[i], NULL);
+    }
+    release_threads(helpers);
+    pthread_mutex_destroy(&queue.lock);
+
+    for (int i = 0; i < queue.count; i++) {
+        if (queue.segments[i].count == 0) continue;
+        state->partial_sum *= queue.segments[i].product;
+        state->last_term = queue.segments[i].last_term;
+        state->n += queue.segments[i].count;
+    }
+
+    free(segment);
+    free(queue.segments);
+    state->sieve_limit = limit;
     return SUCCESS;
 }
 
 
+// prod (p - 1) / p = e^-gamma / ln t * (1 + d), |d| <= 1 / (2 ln^2 t) при t >= 285 (Россер, Шёнфельд)
+// и |d| <= 0.2 / ln^3 t при t >= 2278383 (Дюсар), поэтому оценка ошибается не больше чем на -ln(1 - |d|)
+static double mertens_error_bound(double t) {
+    double l = log(t);
+    double d = t >= MERTENS_DUSART_MIN ? 0.2 / (l * l * l) : 0.5 / (l * l);
+    return -log1p(-d);
+}
+
+
+// gamma = -ln(ln t * prod (p - 1) / p) по теореме Мертенса; t удваивается, пока граница ошибки
+// больше eps, но не дальше GAMMA_SIEVE_MAX. Если граница уже не больше eps, возвращается прежняя оценка
+CalcStatus solve_gamma_equation_resume(ComputeState *state, double eps, double *result) {
+    if (state == NULL || result == NULL || eps <= 0) return ERROR_INVALID_INPUT;
+
+    if (state->sieve_limit < GAMMA_SIEVE_LIMIT) {
+        CalcStatus status = extend_sieve(state, GAMMA_SIEVE_LIMIT);
+        if (status != SUCCESS) return status;
+        state->estimate = -log(log(state->sieve_limit) * state->partial_sum);
+    }
+
+    while (mertens_error_bound(state->sieve_limit) > eps && state->sieve_limit <= GAMMA_SIEVE_MAX / 2) {
+        CalcStatus status = extend_sieve(state, state->sieve_limit * 2);
+        if (status != SUCCESS) return status;
+        state->estimate = -log(log(state->sieve_limit) * state->partial_sum);
+    }
+
+    *result = state->estimate;
+    return mertens_error_bound(state->sieve_limit) <= eps ? SUCCESS : ERROR_NON_CONVERGENCE;
+}
+
+
 CalcStatus solve_gamma_equation(double eps, double *result) {
-    if (eps <= 0) return ERROR_INVALID_INPUT;
-    const int t = 100000;
-    double product = 1.0;
-    
-    char *is_prime = calloc(t + 1, sizeof(char));
-    if (!is_prime) return ERROR_MEMORY;
-    
-    for (int i = 2; i <= t; i++) is_prime[i] = 1;
-    for (int p = 2; p * p <= t; p++) {
-        if (is_prime[p]) {
-            for (int i = p * p; i <= t; i += p) {
-                is_prime[i] = 0;
-            }
+    return run_once(solve_gamma_equation_resume, eps, result);
+}
+
+
+static void *run_compute_jobs(void *arg) {
+    JobQueue *queue = (JobQueue*)arg;
+    for (;;) {
+        pthread_mutex_lock(&queue->lock);
+        int index = queue->next++;
+        pthread_mutex_unlock(&queue->lock);
+        if (index >= queue->count) break;
+
+        ComputeJob *job = &queue->jobs[index];
+        job->result = 0.0;
+        if (job->resume) {
+            job->status = job->resume(job->state, job->eps, &job->result);
+        } else {
+            job->status = job->compute(job->eps, &job->result);
         }
     }
-    
-    for (int p = 2; p <= t; p++) {
-        if (is_prime[p]) {
-            product *= (p - 1.0) / p;
-        }
+    // Очередь пуста: ядро этого потока может взять parallel_block_sum соседней задачи
+    release_threads(1);
+    return NULL;
+}
+
+
+// Все задачи выполняются пулом потоков, вызывающий поток работает наравне с остальными
+static void run_jobs_parallel(ComputeJob *jobs, int count) {
+    JobQueue queue = {jobs, count, 0, PTHREAD_MUTEX_INITIALIZER};
+    int workers = reserve_threads((count < MAX_THREADS ? count : MAX_THREADS) - 1);
+
+    pthread_t ids[MAX_THREADS];
+    bool started[MAX_THREADS] = {false};
+    for (int i = 0; i < workers; i++) {
+        started[i] = pthread_create(&ids[i], NULL, run_compute_jobs, &queue) == 0;
+        if (!started[i]) release_threads(1);
     }
-    
-    free(is_prime);
-    
-    double rhs = log(t) * product;
-    double gamma_approx = -log(rhs);
-    
-    *result = gamma_approx;
-    return SUCCESS;
+    run_compute_jobs(&queue);
+
+    for (int i = 0; i < workers; i++) {
+        if (started[i]) pthread_join(ids[i], NULL);
+    }
+    // Вызывающий поток снова занимает своё место в бюджете
+    claim_thread();
+    pthread_mutex_destroy(&queue.lock);
 }
 
 
 void compute_and_print(double epsilon) {
+    compute_and_print_sweep(&epsilon, 1);
+}
+
+
+void compute_and_print_sweep(const double *epsilons, int count) {
     const char *status_str[] = {
         "SUCCESS",
         "ERROR_INVALID_INPUT",
@@ -359,31 +847,51 @@ void compute_and_print(double epsilon) {
         "ERROR_NON_CONVERGENCE"
     };
 
+    const char *method_str[] = {"Limit:      ", "Series/Prod:", "Equation:   "};
+
+    // Для уравнений без resume-варианта каждый eps считается заново
     struct {
         const char *name;
-        CalcStatus (*limit)(double, double*);
-        CalcStatus (*series)(double, double*);
-        CalcStatus (*equation)(double, double*);
+        ComputeFunction methods[3];
+        ResumableFunction resumable[3];
     } constants[] = {
-        {"e", compute_e_limit, compute_e_series, solve_ln_x_eq_1},
-        {"pi", compute_pi_limit, compute_pi_series, solve_cos_x_eq_minus_1},
-        {"ln(2)", compute_ln2_limit, compute_ln2_series, solve_exp_x_eq_2},
-        {"sqrt(2)", compute_sqrt2_limit, compute_sqrt2_product, solve_x_squared_eq_2},
-        {"gamma", compute_gamma_limit, compute_gamma_series, solve_gamma_equation}
+        {"e", {compute_e_limit, compute_e_series, solve_ln_x_eq_1},
+              {compute_e_limit_resume, compute_e_series_resume, NULL}},
+        {"pi", {compute_pi_limit, compute_pi_series, solve_cos_x_eq_minus_1},
+               {compute_pi_limit_resume, compute_pi_series_resume, NULL}},
+        {"ln(2)", {compute_ln2_limit, compute_ln2_series, solve_exp_x_eq_2},
+                  {compute_ln2_limit_resume, compute_ln2_series_resume, NULL}},
+        {"sqrt(2)", {compute_sqrt2_limit, compute_sqrt2_product, solve_x_squared_eq_2},
+                    {compute_sqrt2_limit_resume, compute_sqrt2_product_resume, NULL}},
+        {"gamma", {compute_gamma_limit, compute_gamma_series, solve_gamma_equation},
+                  {compute_gamma_limit_resume, compute_gamma_series_resume, solve_gamma_equation_resume}}
     };
 
-    for (size_t i = 0; i < sizeof(constants) / sizeof(constants[0]); i++) {
-        printf("\n %s \n", constants[i].name);
-        double res;
-        CalcStatus s;
+    enum { CONSTANT_COUNT = sizeof(constants) / sizeof(constants[0]), JOB_COUNT = CONSTANT_COUNT * 3 };
+    ComputeState states[JOB_COUNT];
+    ComputeJob jobs[JOB_COUNT];
+    for (int i = 0; i < JOB_COUNT; i++) {
+        compute_state_init(&states[i]);
+        jobs[i].compute = constants[i / 3].methods[i % 3];
+        jobs[i].resume = constants[i / 3].resumable[i % 3];
+        jobs[i].state = &states[i];
+    }
+
+    for (int k = 0; k < count; k++) {
+        for (int i = 0; i < JOB_COUNT; i++) {
+            jobs[i].eps = epsilons[k];
+        }
 
-        s = constants[i].limit(epsilon, &res);
-        printf("Limit:      %.15f [%s]\n", res, status_str[s]);
+        run_jobs_parallel(jobs, JOB_COUNT);
 
-        s = constants[i].series(epsilon, &res);
-        printf("Series/Prod:%.15f [%s]\n", res, status_str[s]);
+        if (count > 1) printf("\n Epsilon: %g \n", epsilons[k]);
+        for (int i = 0; i < JOB_COUNT; i++) {
+            if (i % 3 == 0) printf("\n %s \n", constants[i / 3].name);
+            printf("%s%.15f [%s]\n", method_str[i % 3], jobs[i].result, status_str[jobs[i].status]);
+        }
+    }
 
-        s = constants[i].equation(epsilon, &res);
-        printf("Equation:   %.15f [%s]\n", res, status_str[s]);
+    for (int i = 0; i < JOB_COUNT; i++) {
+        compute_state_free(&states[i]);
     }
-}
\ No newline at end of file
+}
@@ -2,6 +2,7 @@
 #define CONSTANTS_CALC_H
 
 #include <stdbool.h>
+#include <stddef.h>
 
 typedef enum {
     SUCCESS,
@@ -11,6 +12,22 @@ typedef enum {
     ERROR_NON_CONVERGENCE
 } CalcStatus;
 
+// Состояние вычисления одного метода для серии запусков с уменьшающимся eps.
+// Одно состояние используется только с одной функцией *_resume
+typedef struct {
+    long long n;            // число обработанных членов или элементов
+    double partial_sum;     // частичная сумма ряда, значение последовательности или произведение
+    double last_term;
+    double estimate;        // последняя оценка после ускорения
+    int *primes;            // простые до sqrt(sieve_limit) для сегментного решета (уравнение для gamma)
+    size_t prime_count;
+    int sieve_limit;
+    void *engine;           // внутреннее состояние сходимости
+} ComputeState;
+
+typedef CalcStatus (*ComputeFunction)(double eps, double *result);
+typedef CalcStatus (*ResumableFunction)(ComputeState *state, double eps, double *result);
+
 // Вспомогательные функции
 bool parse_double(const char *str, double *value);
 
@@ -41,7 +58,25 @@ CalcStatus compute_gamma_limit(double eps, double *result);
 CalcStatus compute_gamma_series(double eps, double *result);
 CalcStatus solve_gamma_equation(double eps, double *result);
 
+// Продолжение вычисления с места остановки предыдущего запуска
+void compute_state_init(ComputeState *state);
+void compute_state_free(ComputeState *state);
+
+CalcStatus compute_e_limit_resume(ComputeState *state, double eps, double *result);
+CalcStatus compute_e_series_resume(ComputeState *state, double eps, double *result);
+CalcStatus compute_pi_limit_resume(ComputeState *state, double eps, double *result);
+CalcStatus compute_pi_series_resume(ComputeState *state, double eps, double *result);
+CalcStatus compute_ln2_limit_resume(ComputeState *state, double eps, double *result);
+CalcStatus compute_ln2_series_resume(ComputeState *state, double eps, double *result);
+CalcStatus compute_sqrt2_limit_resume(ComputeState *state, double eps, double *result);
+CalcStatus compute_sqrt2_product_resume(ComputeState *state, double eps, double *result);
+CalcStatus compute_gamma_limit_resume(ComputeState *state, double eps, double *result);
+CalcStatus compute_gamma_series_resume(ComputeState *state, double eps, double *result);
+CalcStatus solve_gamma_equation_resume(ComputeState *state, double eps, double *result);
+
 // Основная функция вывода
 void compute_and_print(double epsilon);
+// Таблицы для каждого eps по порядку, состояния методов сохраняются между таблицами
+void compute_and_print_sweep(const double *epsilons, int count);
 
 #endif
\ No newline at end of file
@@ -1,20 +1,112 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "constants_calc.h"
+#include "multiprecision.h"
+#include "reference_digits.h"
+
+static const struct {
+    const char *name;
+    MpConstant constant;
+} names[] = {
+    {"e", MP_E}, {"pi", MP_PI}, {"ln2", MP_LN2}, {"sqrt2", MP_SQRT2}, {"gamma", MP_GAMMA}
+};
+
+static int run_digits(int argc, char *argv[]) {
+    char *end;
+    long digits = strtol(argv[2], &end, 10);
+    if (*end != '\0' || digits < 1 || digits > MP_MAX_DIGITS) {
+        fprintf(stderr, "Error: digit count must be between 1 and %d.\n", MP_MAX_DIGITS);
+        return EXIT_FAILURE;
+    }
+
+    int found = 0;
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (argc == 4 && strcmp(argv[3], names[i].name) != 0) continue;
+        found = 1;
+
+        BigFloat value;
+        CalcStatus s = compute_constant_digits(names[i].constant, digits, &value);
+        if (s != SUCCESS) {
+            fprintf(stderr, "Error: failed to compute %s.\n", names[i].name);
+            return EXIT_FAILURE;
+        }
+        printf("%s = ", names[i].name);
+        fflush(stdout);
+        s = write_constant_digits(stdout, &value, digits);
+        bigfloat_free(&value);
+        if (s != SUCCESS) return EXIT_FAILURE;
+    }
+
+    if (!found) {
+        fprintf(stderr, "Error: unknown constant '%s' (e, pi, ln2, sqrt2, gamma).\n", argv[3]);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Сверка первых REFERENCE_DIGITS знаков с эталоном, при такой длине умножение идёт через NTT
+static int run_check_digits(void) {
+    char digits[REFERENCE_DIGITS + 1];
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        BigFloat value;
+        if (compute_constant_digits(names[i].constant, REFERENCE_DIGITS, &value) != SUCCESS) {
+            fprintf(stderr, "Error: failed to compute %s.\n", names[i].name);
+            return EXIT_FAILURE;
+        }
+        format_constant_digits(&value, REFERENCE_DIGITS, digits);
+        bigfloat_free(&value);
+
+        const char *reference = reference_digits[names[i].constant];
+        size_t k = 0;
+        while (k < REFERENCE_DIGITS && digits[k] == reference[k]) k++;
+
+        if (k == REFERENCE_DIGITS) {
+            printf("%s: %d digits OK\n", names[i].name, REFERENCE_DIGITS);
+        } else {
+            printf("%s: mismatch at digit %zu\n", names[i].name, k + 1);
+            failed = 1;
+        }
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
 
 int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <epsilon>\n", argv[0]);
+    if (argc == 2 && strcmp(argv[1], "--check-digits") == 0) {
+        return run_check_digits();
+    }
+
+    if (argc >= 3 && argc <= 4 && strcmp(argv[1], "--digits") == 0) {
+        return run_digits(argc, argv);
+    }
+
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <epsilon> [<epsilon> ...]\n", argv[0]);
+        fprintf(stderr, "       %s --digits <count> [e|pi|ln2|sqrt2|gamma]\n", argv[0]);
+        fprintf(stderr, "       %s --check-digits\n", argv[0]);
         return EXIT_FAILURE;
     }
 
-    double epsilon = 0.0;
-    if (!parse_double(argv[1], &epsilon) || epsilon <= 0.0) {
-        fprintf(stderr, "Error: epsilon must be a positive number.\n");
+    int count = argc - 1;
+    double *epsilons = (double*)malloc(count * sizeof(double));
+    if (!epsilons) {
+        fprintf(stderr, "Error: memory allocation failed.\n");
         return EXIT_FAILURE;
     }
+    for (int i = 0; i < count; i++) {
+        if (!parse_double(argv[i + 1], &epsilons[i]) || epsilons[i] <= 0.0) {
+            fprintf(stderr, "Error: epsilon must be a positive number.\n");
+            free(epsilons);
+            return EXIT_FAILURE;
+        }
+    }
 
-    compute_and_print(epsilon);
+    // Несколько eps: вычисления продолжаются с места, где остановился предыдущий
+    compute_and_print_sweep(epsilons, count);
 
+    free(epsilons);
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
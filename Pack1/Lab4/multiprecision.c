@@ -0,0 +1,1057 @@
+#include "multiprecision.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+
+#define SCHOOLBOOK_LIMIT 40
+#define NTT_MAX_LOG 23
+#define GUARD_LIMBS 3
+#define WRITER_BUFFER 65536
+
+typedef unsigned __int128 uint128_t;
+
+typedef struct {
+    uint32_t p;
+    uint32_t inverse;
+    uint32_t r2;
+    uint32_t generator;
+} NttPrime;
+
+static NttPrime ntt_primes[3] = {
+    {998244353u, 0, 0, 3},
+    {167772161u, 0, 0, 3},
+    {469762049u, 0, 0, 3}
+};
+
+
+static void ntt_setup(void) {
+    for (int i = 0; i < 3; i++) {
+        NttPrime *q = &ntt_primes[i];
+        if (q->r2 != 0) continue;
+        uint32_t inv = q->p;
+        for (int k = 0; k < 5; k++) inv *= 2 - q->p * inv;
+        q->inverse = (uint32_t)-inv;
+        q->r2 = (uint32_t)(((uint128_t)1 << 64) % q->p);
+    }
+}
+
+
+static inline uint32_t mont_mul(uint32_t a, uint32_t b, const NttPrime *q) {
+    uint64_t t = (uint64_t)a * b;
+    uint32_t m = (uint32_t)t * q->inverse;
+    uint32_t u = (uint32_t)((t + (uint64_t)m * q->p) >> 32);
+    return u >= q->p ? u - q->p : u;
+}
+
+
+static uint64_t pow_mod(uint64_t base, uint64_t exponent, uint64_t mod) {
+    uint64_t result = 1;
+    base %= mod;
+    while (exponent) {
+        if (exponent & 1) result = result * base % mod;
+        base = base * base % mod;
+        exponent >>= 1;
+    }
+    return result;
+}
+
+
+// Корни этапа длины len лежат подряд в roots[len / 2 .. len), в форме Монтгомери
+static void ntt(uint32_t *a, size_t n, const uint32_t *roots, NttPrime prime) {
+    const NttPrime *q = &prime;
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            uint32_t t = a[i];
+            a[i] = a[j];
+            a[j] = t;
+        }
+    }
+
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len >> 1;
+        const uint32_t *w = roots + half;
+        for (size_t i = 0; i < n; i += len) {
+            for (size_t j = 0; j < half; j++) {
+                uint32_t u = a[i + j];
+                uint32_t v = mont_mul(a[i + j + half], w[j], q);
+                uint32_t sum = u + v;
+                a[i + j] = sum >= q->p ? sum - q->p : sum;
+                a[i + j + half] = u >= v ? u - v : u + q->p - v;
+            }
+        }
+    }
+}
+
+
+static void fill_roots(uint32_t *roots, size_t n, uint64_t w, NttPrime prime) {
+    const NttPrime *q = &prime;
+    uint32_t one = mont_mul(1, q->r2, q);
+    for (size_t len = n; len >= 2; len >>= 1) {
+        size_t half = len >> 1;
+        uint32_t step = mont_mul((uint32_t)w, q->r2, q);
+        roots[half] = one;
+        for (size_t j = 1; j < half; j++) {
+            roots[half + j] = mont_mul(roots[half + j - 1], step, q);
+        }
+        w = w * w % q->p;
+    }
+}
+
+
+// Свёртка по одному модулю: out[i] = (a * b)[i] mod p
+static void convolve_mod(const uint32_t *a, size_t an, const uint32_t *b, size_t bn, size_t n,
+                         NttPrime prime, uint32_t *fa, uint32_t *fb, uint32_t *roots, uint32_t *out) {
+    const NttPrime *q = &prime;
+    bool square = a == b && an == bn;
+    for (size_t i = 0; i < n; i++) {
+        fa[i] = i < an ? mont_mul(a[i] % q->p, q->r2, q) : 0;
+    }
+    uint64_t w = pow_mod(q->generator, (q->p - 1) / n, q->p);
+    fill_roots(roots, n, w, *q);
+    ntt(fa, n, roots, *q);
+
+    if (square) {
+        for (size_t i = 0; i < n; i++) fa[i] = mont_mul(fa[i], fa[i], q);
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            fb[i] = i < bn ? mont_mul(b[i] % q->p, q->r2, q) : 0;
+        }
+        ntt(fb, n, roots, *q);
+        for (size_t i = 0; i < n; i++) fa[i] = mont_mul(fa[i], fb[i], q);
+    }
+
+    fill_roots(roots, n, pow_mod(w, q->p - 2, q->p), *q);
+    ntt(fa, n, roots, *q);
+    uint32_t scale = mont_mul((uint32_t)pow_mod(n, q->p - 2, q->p), q->r2, q);
+    for (size_t i = 0; i < n; i++) {
+        out[i] = mont_mul(mont_mul(fa[i], scale, q), 1, q);
+    }
+}
+
+
+static bool multiply_ntt(const uint32_t *a, size_t an, const uint32_t *b, size_t bn, uint32_t *r) {
+    size_t n = 1;
+    int log = 0;
+    while (n < an + bn - 1) {
+        n <<= 1;
+        log++;
+    }
+    if (log > NTT_MAX_LOG) return false;
+
+    uint32_t *work = malloc(6 * n * sizeof(uint32_t));
+    if (work == NULL) return false;
+    uint32_t *fa = work, *fb = work + n, *roots = work + 2 * n;
+    uint32_t *res[3] = {work + 3 * n, work + 4 * n, work + 5 * n};
+
+    ntt_setup();
+    for (int k = 0; k < 3; k++) {
+        convolve_mod(a, an, b, bn, n, ntt_primes[k], fa, fb, roots, res[k]);
+    }
+
+    uint64_t p1 = ntt_primes[0].p, p2 = ntt_primes[1].p, p3 = ntt_primes[2].p;
+    uint64_t inv_p1 = pow_mod(p1, p2 - 2, p2);
+    uint64_t inv_p12 = pow_mod(p1 * p2 % p3, p3 - 2, p3);
+    uint128_t carry = 0;
+
+    for (size_t i = 0; i < an + bn; i++) {
+        uint128_t value = carry;
+        if (i < an + bn - 1) {
+            uint64_t x1 = res[0][i];
+            uint64_t x2 = (res[1][i] + p2 - x1 % p2) % p2 * inv_p1 % p2;
+            uint64_t low = (x1 + x2 % p3 * p1) % p3;
+            uint64_t x3 = (res[2][i] + p3 - low) % p3 * inv_p12 % p3;
+            value += x1 + (uint128_t)x2 * p1 + (uint128_t)x3 * p1 * p2;
+        }
+        r[i] = (uint32_t)(value % MP_BASE);
+        carry = value / MP_BASE;
+    }
+
+    free(work);
+    return true;
+}
+
+
+static void multiply_schoolbook(const uint32_t *a, size_t an, const uint32_t *b, size_t bn, uint32_t *r) {
+    memset(r, 0, (an + bn) * sizeof(uint32_t));
+    for (size_t i = 0; i < an; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < bn; j++) {
+            uint64_t t = (uint64_t)a[i] * b[j] + r[i + j] + carry;
+            carry = t / MP_BASE;
+            r[i + j] = (uint32_t)(t - carry * MP_BASE);
+        }
+        r[i + bn] = (uint32_t)carry;
+    }
+}
+
+
+static void bigint_init(BigInt *x) {
+    x->limbs = NULL;
+    x->length = 0;
+    x->capacity = 0;
+    x->sign = 1;
+}
+
+
+static void bigint_free(BigInt *x) {
+    free(x->limbs);
+    bigint_init(x);
+}
+
+
+static bool bigint_reserve(BigInt *x, size_t capacity) {
+    if (capacity <= x->capacity) return true;
+    uint32_t *limbs = realloc(x->limbs, capacity * sizeof(uint32_t));
+    if (limbs == NULL) return false;
+    x->limbs = limbs;
+    x->capacity = capacity;
+    return true;
+}
+
+
+static void bigint_trim(BigInt *x) {
+    while (x->length > 0 && x->limbs[x->length - 1] == 0) x->length--;
+    if (x->length == 0) x->sign = 1;
+}
+
+
+static bool bigint_set_u64(BigInt *x, uint64_t value) {
+    if (!bigint_reserve(x, 3)) return false;
+    x->sign = 1;
+    x->length = 0;
+    while (value > 0) {
+        x->limbs[x->length++] = (uint32_t)(value % MP_BASE);
+        value /= MP_BASE;
+    }
+    return true;
+}
+
+
+static bool bigint_copy(BigInt *dst, const BigInt *src) {
+    if (!bigint_reserve(dst, src->length)) return false;
+    if (src->length > 0) memcpy(dst->limbs, src->limbs, src->length * sizeof(uint32_t));
+    dst->length = src->length;
+    dst->sign = src->sign;
+    return true;
+}
+
+
+static void bigint_swap(BigInt *a, BigInt *b) {
+    BigInt t = *a;
+    *a = *b;
+    *b = t;
+}
+
+
+static int compare_magnitude(const BigInt *a, const BigInt *b) {
+    if (a->length != b->length) return a->length < b->length ? -1 : 1;
+    for (size_t i = a->length; i-- > 0; ) {
+        if (a->limbs[i] != b->limbs[i]) return a->limbs[i] < b->limbs[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+
+// r = a + sign * b; r не должен совпадать с a или b
+static bool bigint_add_signed(BigInt *r, const BigInt *a, const BigInt *b, int sign) {
+    int b_sign = b->sign * sign;
+    if (b->length == 0) return bigint_copy(r, a);
+    if (a->length == 0) {
+        if (!bigint_copy(r, b)) return false;
+        r->sign = b_sign;
+        return true;
+    }
+
+    if (a->sign == b_sign) {
+        const BigInt *big = a->length >= b->length ? a : b;
+        const BigInt *small = big == a ? b : a;
+        if (!bigint_reserve(r, big->length + 1)) return false;
+        uint32_t carry = 0;
+        for (size_t i = 0; i < big->length; i++) {
+            uint32_t t = big->limbs[i] + (i < small->length ? small->limbs[i] : 0) + carry;
+            carry = t >= MP_BASE;
+            r->limbs[i] = carry ? t - MP_BASE : t;
+        }
+        r->limbs[big->length] = carry;
+        r->length = big->length + 1;
+        r->sign = a->sign;
+    } else {
+        int cmp = compare_magnitude(a, b);
+        if (cmp == 0) {
+            r->length = 0;
+            r->sign = 1;
+            return true;
+        }
+        const BigInt *big = cmp > 0 ? a : b;
+        const BigInt *small = cmp > 0 ? b : a;
+        if (!bigint_reserve(r, big->length)) return false;
+        uint32_t borrow = 0;
+        for (size_t i = 0; i < big->length; i++) {
+            uint32_t s = (i < small->length ? small->limbs[i] : 0) + borrow;
+            borrow = big->limbs[i] < s;
+            r->limbs[i] = borrow ? big->limbs[i] + MP_BASE - s : big->limbs[i] - s;
+        }
+        r->length = big->length;
+        r->sign = cmp > 0 ? a->sign : b_sign;
+    }
+    bigint_trim(r);
+    return true;
+}
+
+
+// r = a * b; r не должен совпадать с a или b
+static bool bigint_mul(BigInt *r, const BigInt *a, const BigInt *b) {
+    if (a->length == 0 || b->length == 0) {
+        r->length = 0;
+        r->sign = 1;
+        return true;
+    }
+    if (!bigint_reserve(r, a->length + b->length)) return false;
+
+    size_t shorter = a->length < b->length ? a->length : b->length;
+    if (shorter < SCHOOLBOOK_LIMIT) {
+        multiply_schoolbook(a->limbs, a->length, b->limbs, b->length, r->limbs);
+    } else if (!multiply_ntt(a->limbs, a->length, b->limbs, b->length, r->limbs)) {
+        return false;
+    }
+    r->length = a->length + b->length;
+    r->sign = a->sign * b->sign;
+    bigint_trim(r);
+    return true;
+}
+
+
+static bool bigint_mul_small(BigInt *x, uint32_t factor) {
+    if (!bigint_reserve(x, x->length + 2)) return false;
+    uint64_t carry = 0;
+    for (size_t i = 0; i < x->length; i++) {
+        uint64_t t = (uint64_t)x->limbs[i] * factor + carry;
+        carry = t / MP_BASE;
+        x->limbs[i] = (uint32_t)(t - carry * MP_BASE);
+    }
+    while (carry > 0) {
+        x->limbs[x->length++] = (uint32_t)(carry % MP_BASE);
+        carry /= MP_BASE;
+    }
+    bigint_trim(x);
+    return true;
+}
+
+
+// x = x * y с временным буфером
+static bool bigint_mul_into(BigInt *x, const BigInt *y, BigInt *scratch) {
+    if (!bigint_mul(scratch, x, y)) return false;
+    bigint_swap(x, scratch);
+    return true;
+}
+
+
+static void bigfloat_init(BigFloat *x) {
+    bigint_init(&x->mantissa);
+    x->exponent = 0;
+}
+
+
+void bigfloat_free(BigFloat *x) {
+    if (x == NULL) return;
+    bigint_free(&x->mantissa);
+    x->exponent = 0;
+}
+
+
+static void bigfloat_truncate(BigFloat *x, size_t precision) {
+    BigInt *m = &x->mantissa;
+    bigint_trim(m);
+    if (m->length > precision) {
+        size_t drop = m->length - precision;
+        memmove(m->limbs, m->limbs + drop, precision * sizeof(uint32_t));
+        m->length = precision;
+        x->exponent += (long long)drop;
+    }
+    size_t zeros = 0;
+    while (zeros < m->length && m->limbs[zeros] == 0) zeros++;
+    if (zeros > 0 && zeros < m->length) {
+        memmove(m->limbs, m->limbs + zeros, (m->length - zeros) * sizeof(uint32_t));
+        m->length -= zeros;
+        x->exponent += (long long)zeros;
+    }
+}
+
+
+static bool bigfloat_mul(BigFloat *r, const BigFloat *a, const BigFloat *b, size_t precision) {
+    if (!bigint_mul(&r->mantissa, &a->mantissa, &b->mantissa)) return false;
+    r->exponent = a->exponent + b->exponent;
+    bigfloat_truncate(r, precision);
+    return true;
+}
+
+
+// Копия x, сдвинутая к показателю target <= x->exponent
+static bool aligned_copy(BigInt *dst, const BigFloat *x, long long target) {
+    size_t shift = (size_t)(x->exponent - target);
+    if (!bigint_reserve(dst, x->mantissa.length + shift)) return false;
+    memset(dst->limbs, 0, shift * sizeof(uint32_t));
+    if (x->mantissa.length > 0) {
+        memcpy(dst->limbs + shift, x->mantissa.limbs, x->mantissa.length * sizeof(uint32_t));
+    }
+    dst->length = x->mantissa.length + shift;
+    dst->sign = x->mantissa.sign;
+    return true;
+}
+
+
+static bool bigfloat_add_signed(BigFloat *r, const BigFloat *a, const BigFloat *b, int sign, size_t precision) {
+    if (b->mantissa.length == 0 || a->mantissa.length == 0) {
+        const BigFloat *x = b->mantissa.length == 0 ? a : b;
+        if (!bigint_copy(&r->mantissa, &x->mantissa)) return false;
+        if (x == b) r->mantissa.sign *= sign;
+        r->exponent = x->exponent;
+        bigint_trim(&r->mantissa);
+        return true;
+    }
+
+    long long top_a = a->exponent + (long long)a->mantissa.length;
+    long long top_b = b->exponent + (long long)b->mantissa.length;
+    long long top = top_a > top_b ? top_a : top_b;
+    long long floor = top - (long long)precision - 2;
+    long long target = a->exponent < b->exponent ? a->exponent : b->exponent;
+    if (target < floor) target = floor;
+
+    BigFloat parts[2];
+    const BigFloat *inputs[2] = {a, b};
+    for (int i = 0; i < 2; i++) {
+        bigfloat_init(&parts[i]);
+        if (!bigint_copy(&parts[i].mantissa, &inputs[i]->mantissa)) {
+            bigfloat_free(&parts[0]);
+            bigfloat_free(&parts[1]);
+            return false;
+        }
+        parts[i].exponent = inputs[i]->exponent;
+        if (parts[i].exponent < target) {
+            long long drop = target - parts[i].exponent;
+            BigInt *m = &parts[i].mantissa;
+            if ((size_t)drop >= m->length) {
+                m->length = 0;
+            } else {
+                memmove(m->limbs, m->limbs + drop, (m->length - (size_t)drop) * sizeof(uint32_t));
+                m->length -= (size_t)drop;
+            }
+            parts[i].exponent = target;
+        }
+    }
+
+    BigInt x, y;
+    bigint_init(&x);
+    bigint_init(&y);
+    bool ok = aligned_copy(&x, &parts[0], target) && aligned_copy(&y, &parts[1], target) &&
+              bigint_add_signed(&r->mantissa, &x, &y, sign);
+    r->exponent = target;
+    bigint_free(&x);
+    bigint_free(&y);
+    bigfloat_free(&parts[0]);
+    bigfloat_free(&parts[1]);
+    if (ok) bigfloat_truncate(r, precision);
+    return ok;
+}
+
+
+static bool bigfloat_set_u64(BigFloat *x, uint64_t value) {
+    x->exponent = 0;
+    return bigint_set_u64(&x->mantissa, value);
+}
+
+
+// Старшие цифры x в виде m * BASE^e, m < BASE^2
+static double leading_value(const BigFloat *x, long long *exponent) {
+    const BigInt *m = &x->mantissa;
+    double value = m->limbs[m->length - 1];
+    if (m->length >= 2) {
+        value = value * MP_BASE + m->limbs[m->length - 2];
+        *exponent = x->exponent + (long long)m->length - 2;
+    } else {
+        *exponent = x->exponent + (long long)m->length - 1;
+    }
+    return value;
+}
+
+
+// Начальное приближение value * BASE^exponent с точностью double
+static bool bigfloat_from_estimate(BigFloat *x, double value, long long exponent) {
+    while (value < 1e15) {
+        value *= MP_BASE;
+        exponent--;
+    }
+    while (value >= 1e18) {
+        value /= MP_BASE;
+        exponent++;
+    }
+    x->exponent = exponent;
+    return bigint_set_u64(&x->mantissa, (uint64_t)value);
+}
+
+
+static size_t newton_steps(size_t precision, size_t *levels) {
+    size_t count = 0;
+    for (size_t p = precision; ; p = p / 2 + 1) {
+        levels[count++] = p;
+        if (p <= 2) break;
+    }
+    return count;
+}
+
+
+// x = 1 / a, итерация Ньютона x += x (1 - a x) с удвоением точности
+static bool bigfloat_reciprocal(BigFloat *x, const BigFloat *a, size_t precision) {
+    long long e;
+    double lead = leading_value(a, &e);
+    if (!bigfloat_from_estimate(x, 1.0 / lead, -e)) return false;
+    if (a->mantissa.sign < 0) x->mantissa.sign = -1;
+
+    size_t levels[64];
+    size_t count = newton_steps(precision + GUARD_LIMBS, levels);
+    BigFloat one, t, d;
+    bigfloat_init(&one);
+    bigfloat_init(&t);
+    bigfloat_init(&d);
+    bool ok = bigfloat_set_u64(&one, 1);
+
+    for (size_t i = count; ok && i-- > 0; ) {
+        size_t p = levels[i];
+        ok = bigfloat_mul(&t, a, x, p) &&
+             bigfloat_add_signed(&d, &one, &t, -1, p) &&
+             bigfloat_mul(&t, x, &d, p) &&
+             bigfloat_add_signed(&d, x, &t, 1, p);
+        if (ok) {
+            BigFloat s = *x;
+            *x = d;
+            d = s;
+        }
+    }
+
+    bigfloat_free(&one);
+    bigfloat_free(&t);
+    bigfloat_free(&d);
+    return ok;
+}
+
+
+// x = 1 / sqrt(a), итерация x += x (1 - a x^2) / 2
+static bool bigfloat_rsqrt(BigFloat *x, const BigFloat *a, size_t precision) {
+    long long e;
+    double lead = leading_value(a, &e);
+    if (e % 2 != 0) {
+        lead *= MP_BASE;
+        e--;
+    }
+    if (!bigfloat_from_estimate(x, 1.0 / sqrt(lead), -e / 2)) return false;
+
+    size_t levels[64];
+    size_t count = newton_steps(precision + GUARD_LIMBS, levels);
+    BigFloat one, t, d;
+    bigfloat_init(&one);
+    bigfloat_init(&t);
+    bigfloat_init(&d);
+    bool ok = bigfloat_set_u64(&one, 1);
+
+    for (size_t i = count; ok && i-- > 0; ) {
+        size_t p = levels[i];
+        ok = bigfloat_mul(&t, x, x, p) &&
+             bigfloat_mul(&d, a, &t, p) &&
+             bigfloat_add_signed(&t, &one, &d, -1, p) &&
+             bigfloat_mul(&d, x, &t, p) &&
+             bigint_mul_small(&d.mantissa, MP_BASE / 2);
+        if (ok) {
+            d.exponent -= 1;
+            ok = bigfloat_add_signed(&t, x, &d, 1, p);
+        }
+        if (ok) {
+            BigFloat s = *x;
+            *x = t;
+            t = s;
+        }
+    }
+
+    bigfloat_free(&one);
+    bigfloat_free(&t);
+    bigfloat_free(&d);
+    return ok;
+}
+
+
+static bool bigfloat_from_bigint(BigFloat *x, BigInt *value) {
+    bigint_swap(&x->mantissa, value);
+    x->exponent = 0;
+    bigint_trim(&x->mantissa);
+    return true;
+}
+
+
+// numerator / denominator
+static bool bigfloat_divide(BigFloat *r, BigInt *numerator, BigInt *denominator, size_t precision) {
+    BigFloat n, d, inv;
+    bigfloat_init(&n);
+    bigfloat_init(&d);
+    bigfloat_init(&inv);
+    bigfloat_from_bigint(&n, numerator);
+    bigfloat_from_bigint(&d, denominator);
+    bigfloat_truncate(&n, precision + GUARD_LIMBS);
+    bigfloat_truncate(&d, precision + GUARD_LIMBS);
+    bool ok = bigfloat_reciprocal(&inv, &d, precision) && bigfloat_mul(r, &n, &inv, precision + GUARD_LIMBS);
+    bigfloat_free(&n);
+    bigfloat_free(&d);
+    bigfloat_free(&inv);
+    return ok;
+}
+
+
+/*
+ * Бинарное разбиение суммы S = sum a(n)/b(n) * p(0)...p(n) / (q(0)...q(n))
+ * (Haible, Papanikolaou): S = T / (B Q) на отрезке [0, N).
+ */
+typedef struct {
+    BigInt P, Q, B, T;
+} Split;
+
+typedef bool (*SplitLeaf)(long long n, void *context, Split *leaf);
+
+
+static void split_init(Split *s) {
+    bigint_init(&s->P);
+    bigint_init(&s->Q);
+    bigint_init(&s->B);
+    bigint_init(&s->T);
+}
+
+
+static void split_free(Split *s) {
+    bigint_free(&s->P);
+    bigint_free(&s->Q);
+    bigint_free(&s->B);
+    bigint_free(&s->T);
+}
+
+
+static bool binary_split(long long a, long long b, SplitLeaf leaf, void *context, Split *out) {
+    if (b - a == 1) return leaf(a, context, out);
+
+    long long m = a + (b - a) / 2;
+    Split right;
+    split_init(&right);
+    BigInt x, y;
+    bigint_init(&x);
+    bigint_init(&y);
+
+    bool ok = binary_split(a, m, leaf, context, out) && binary_split(m, b, leaf, context, &right) &&
+              bigint_mul(&x, &right.B, &right.Q) &&
+              bigint_mul(&y, &x, &out->T) &&
+              bigint_mul(&x, &out->B, &out->P) &&
+              bigint_mul(&out->T, &x, &right.T) &&
+              bigint_add_signed(&x, &y, &out->T, 1);
+    if (ok) {
+        bigint_swap(&out->T, &x);
+        ok = bigint_mul_into(&out->P, &right.P, &x) &&
+             bigint_mul_into(&out->Q, &right.Q, &x) &&
+             bigint_mul_into(&out->B, &right.B, &x);
+    }
+
+    bigint_free(&x);
+    bigint_free(&y);
+    split_free(&right);
+    return ok;
+}
+
+
+// S = T / (B Q)
+static bool split_value(Split *s, size_t precision, BigFloat *result) {
+    BigInt d;
+    bigint_init(&d);
+    bool ok = bigint_mul(&d, &s->B, &s->Q) && bigfloat_divide(result, &s->T, &d, precision);
+    bigint_free(&d);
+    return ok;
+}
+
+
+static bool e_leaf(long long n, void *context, Split *leaf) {
+    (void)context;
+    return bigint_set_u64(&leaf->P, 1) && bigint_set_u64(&leaf->Q, n == 0 ? 1 : (uint64_t)n) &&
+           bigint_set_u64(&leaf->B, 1) && bigint_set_u64(&leaf->T, 1);
+}
+
+
+static bool atanh_leaf(long long n, void *context, Split *leaf) {
+    uint64_t x = *(const uint64_t*)context;
+    return bigint_set_u64(&leaf->P, 1) && bigint_set_u64(&leaf->Q, n == 0 ? x : x * x) &&
+           bigint_set_u64(&leaf->B, (uint64_t)(2 * n + 1)) && bigint_set_u64(&leaf->T, 1);
+}
+
+
+static bool chudnovsky_leaf(long long n, void *context, Split *leaf) {
+    (void)context;
+    if (!bigint_set_u64(&leaf->B, 1)) return false;
+    if (n == 0) {
+        return bigint_set_u64(&leaf->P, 1) && bigint_set_u64(&leaf->Q, 1) && bigint_set_u64(&leaf->T, 13591409);
+    }
+
+    uint64_t k = (uint64_t)n;
+    bool ok = bigint_set_u64(&leaf->P, (6 * k - 5) * (2 * k - 1)) && bigint_mul_small(&leaf->P, (uint32_t)(6 * k - 1)) &&
+              bigint_set_u64(&leaf->Q, k * k) && bigint_mul_small(&leaf->Q, (uint32_t)k) &&
+              bigint_mul_small(&leaf->Q, 640320) && bigint_mul_small(&leaf->Q, 640320) &&
+              bigint_mul_small(&leaf->Q, 26680) &&
+              bigint_set_u64(&leaf->T, 13591409 + 545140134 * k);
+    if (!ok) return false;
+
+    BigInt t;
+    bigint_init(&t);
+    ok = bigint_mul(&t, &leaf->T, &leaf->P);
+    bigint_swap(&t, &leaf->T);
+    bigint_free(&t);
+    leaf->P.sign = -1;
+    leaf->T.sign = -1;
+    return ok;
+}
+
+
+static bool sum_series(long long terms, SplitLeaf leaf, void *context, size_t precision, BigFloat *result) {
+    Split s;
+    split_init(&s);
+    bool ok = binary_split(0, terms, leaf, context, &s) && split_value(&s, precision, result);
+    split_free(&s);
+    return ok;
+}
+
+
+static bool compute_e(long digits, size_t precision, BigFloat *result) {
+    long long terms = 2;
+    double log_factorial = 0;
+    while (log_factorial < digits + 10) {
+        log_factorial += log10((double)terms);
+        terms++;
+    }
+    return sum_series(terms, e_leaf, NULL, precision, result);
+}
+
+
+static bool compute_atanh_inverse(uint64_t x, long digits, size_t precision, BigFloat *result) {
+    long long terms = (long long)((digits + 10) / (2 * log10((double)x))) + 2;
+    return sum_series(terms, atanh_leaf, &x, precision, result);
+}
+
+
+// ln 2 = 18 atanh(1/26) - 2 atanh(1/4801) + 8 atanh(1/8749)
+static bool compute_ln2(long digits, size_t precision, BigFloat *result) {
+    static const uint64_t arguments[3] = {26, 4801, 8749};
+    static const uint32_t weights[3] = {18, 2, 8};
+    static const int signs[3] = {1, -1, 1};
+
+    BigFloat part, sum;
+    bigfloat_init(&part);
+    bigfloat_init(&sum);
+    bool ok = true;
+
+    for (int i = 0; ok && i < 3; i++) {
+        ok = compute_atanh_inverse(arguments[i], digits, precision, &part) &&
+             bigint_mul_small(&part.mantissa, weights[i]) &&
+             bigfloat_add_signed(result, &sum, &part, signs[i], precision + GUARD_LIMBS);
+        if (ok) {
+            BigFloat t = sum;
+            sum = *result;
+            *result = t;
+        }
+    }
+    if (ok) {
+        BigFloat t = sum;
+        sum = *result;
+        *result = t;
+    }
+
+    bigfloat_free(&part);
+    bigfloat_free(&sum);
+    return ok;
+}
+
+
+// pi = 426880 sqrt(10005) / S (Chudnovsky)
+static bool compute_pi(long digits, size_t precision, BigFloat *result) {
+    long long terms = (long long)(digits / 14.181647462725477) + 2;
+    BigFloat series, inverse, root, radicand;
+    bigfloat_init(&series);
+    bigfloat_init(&inverse);
+    bigfloat_init(&root);
+    bigfloat_init(&radicand);
+
+    bool ok = sum_series(terms, chudnovsky_leaf, NULL, precision, &series) &&
+              bigfloat_reciprocal(&inverse, &series, precision) &&
+              bigfloat_set_u64(&radicand, 10005) &&
+              bigfloat_rsqrt(&root, &radicand, precision) &&
+              bigint_mul_small(&root.mantissa, 10005) &&
+              bigint_mul_small(&root.mantissa, 426880) &&
+              bigfloat_mul(result, &root, &inverse, precision + GUARD_LIMBS);
+
+    bigfloat_free(&series);
+    bigfloat_free(&inverse);
+    bigfloat_free(&root);
+    bigfloat_free(&radicand);
+    return ok;
+}
+
+
+// sqrt 2 = 2 / sqrt(2)
+static bool compute_sqrt2(size_t precision, BigFloat *result) {
+    BigFloat two;
+    bigfloat_init(&two);
+    bool ok = bigfloat_set_u64(&two, 2) && bigfloat_rsqrt(result, &two, precision) &&
+              bigint_mul_small(&result->mantissa, 2);
+    bigfloat_free(&two);
+    return ok;
+}
+
+
+/*
+ * Brent-McMillan: gamma = A / B - C / B^2 - ln n с погрешностью O(e^(-8n)), где
+ * B = sum (n^k / k!)^2, A = sum (n^k / k!)^2 H_k, C = 1/(4n) sum_(k<=2n) ((2k)!)^3 / ((k!)^4 (16n)^(2k)).
+ * На [a, b): T / Q - вклад в B, V / (D Q) - в A, C / D = H_(b-1) - H_(a-1).
+ */
+typedef struct {
+    BigInt P, Q, D, C, T, V;
+} GammaSplit;
+
+
+static void gamma_split_init(GammaSplit *s) {
+    bigint_init(&s->P);
+    bigint_init(&s->Q);
+    bigint_init(&s->D);
+    bigint_init(&s->C);
+    bigint_init(&s->T);
+    bigint_init(&s->V);
+}
+
+
+static void gamma_split_free(GammaSplit *s) {
+    bigint_free(&s->P);
+    bigint_free(&s->Q);
+    bigint_free(&s->D);
+    bigint_free(&s->C);
+    bigint_free(&s->T);
+    bigint_free(&s->V);
+}
+
+
+static bool gamma_split(long long a, long long b, uint64_t n2, GammaSplit *out) {
+    if (b - a == 1) {
+        uint64_t k = (uint64_t)a;
+        return bigint_set_u64(&out->P, n2) && bigint_set_u64(&out->Q, k * k) &&
+               bigint_set_u64(&out->D, k) && bigint_set_u64(&out->C, 1) &&
+               bigint_set_u64(&out->T, n2) && bigint_set_u64(&out->V, n2);
+    }
+
+    long long m = a + (b - a) / 2;
+    GammaSplit r;
+    gamma_split_init(&r);
+    BigInt x, y, z;
+    bigint_init(&x);
+    bigint_init(&y);
+    bigint_init(&z);
+
+    // V = Dr Qr Vl + Pl (Cl Dr Tr + Dl Vr)
+    bool ok = gamma_split(a, m, n2, out) && gamma_split(m, b, n2, &r) &&
+              bigint_mul(&x, &out->C, &r.D) &&
+              bigint_mul(&y, &x, &r.T) &&
+              bigint_mul(&x, &out->D, &r.V) &&
+              bigint_add_signed(&z, &y, &x, 1) &&
+              bigint_mul(&x, &out->P, &z) &&
+              bigint_mul(&y, &r.D, &r.Q) &&
+              bigint_mul(&z, &y, &out->V) &&
+              bigint_add_signed(&out->V, &z, &x, 1);
+
+    // T = Tl Qr + Pl Tr
+    ok = ok && bigint_mul(&x, &out->T, &r.Q) &&
+         bigint_mul(&y, &out->P, &r.T) &&
+         bigint_add_signed(&out->T, &x, &y, 1);
+
+    // C = Cl Dr + Dl Cr
+    ok = ok && bigint_mul(&x, &out->C, &r.D) &&
+         bigint_mul(&y, &out->D, &r.C) &&
+         bigint_add_signed(&out->C, &x, &y, 1);
+
+    ok = ok && bigint_mul_into(&out->P, &r.P, &x) &&
+         bigint_mul_into(&out->Q, &r.Q, &x) &&
+         bigint_mul_into(&out->D, &r.D, &x);
+
+    bigint_free(&x);
+    bigint_free(&y);
+    bigint_free(&z);
+    gamma_split_free(&r);
+    return ok;
+}
+
+
+// Член C: ((2k)!)^3 / ((k!)^4 (16n)^(2k)) = prod (2j-1)^3 / (32 j n^2)
+static bool gamma_tail_leaf(long long k, void *context, Split *leaf) {
+    uint32_t n = *(const uint32_t*)context;
+    if (k == 0) {
+        return bigint_set_u64(&leaf->P, 1) && bigint_set_u64(&leaf->Q, 1) &&
+               bigint_set_u64(&leaf->B, 1) && bigint_set_u64(&leaf->T, 1);
+    }
+    uint64_t odd = (uint64_t)(2 * k - 1);
+    return bigint_set_u64(&leaf->P, odd * odd * odd) && bigint_set_u64(&leaf->Q, (uint64_t)k * 32) &&
+           bigint_mul_small(&leaf->Q, n) && bigint_mul_small(&leaf->Q, n) &&
+           bigint_set_u64(&leaf->B, 1) && bigint_set_u64(&leaf->T, odd * odd * odd);
+}
+
+
+static bool compute_gamma(long digits, size_t precision, BigFloat *result) {
+    int log2_n = 1;
+    while (ldexp(1.0, log2_n) * 8 < (digits + 10) * log(10.0)) log2_n++;
+    uint32_t n = 1u << log2_n;
+    long long terms = (long long)ceil(4.9706 * n) + 1;
+
+    GammaSplit s;
+    gamma_split_init(&s);
+    BigFloat ratio, ln2, b_value, square, tail, inverse;
+    bigfloat_init(&ratio);
+    bigfloat_init(&ln2);
+    bigfloat_init(&b_value);
+    bigfloat_init(&square);
+    bigfloat_init(&tail);
+    bigfloat_init(&inverse);
+    BigInt denominator, x;
+    bigint_init(&denominator);
+    bigint_init(&x);
+
+    // A / B = V / (D (Q + T)), B = (Q + T) / Q
+    bool ok = gamma_split(1, terms, (uint64_t)n * n, &s) &&
+              bigint_add_signed(&x, &s.Q, &s.T, 1) &&
+              bigint_mul(&denominator, &s.D, &x) &&
+              bigfloat_divide(&ratio, &s.V, &denominator, precision) &&
+              bigfloat_divide(&b_value, &x, &s.Q, precision);
+    gamma_split_free(&s);
+
+    // C / B^2 = S / (4n B^2)
+    ok = ok && sum_series(2 * (long long)n + 1, gamma_tail_leaf, &n, precision, &tail) &&
+         bigfloat_mul(&square, &b_value, &b_value, precision + GUARD_LIMBS) &&
+         bigint_mul_small(&square.mantissa, (uint32_t)(4 * n)) &&
+         bigfloat_reciprocal(&inverse, &square, precision) &&
+         bigfloat_mul(&square, &tail, &inverse, precision + GUARD_LIMBS) &&
+         bigfloat_add_signed(&tail, &ratio, &square, -1, precision + GUARD_LIMBS);
+
+    ok = ok && compute_ln2(digits, precision, &ln2) &&
+         bigint_mul_small(&ln2.mantissa, (uint32_t)log2_n) &&
+         bigfloat_add_signed(result, &tail, &ln2, -1, precision + GUARD_LIMBS);
+
+    bigfloat_free(&ratio);
+    bigfloat_free(&ln2);
+    bigfloat_free(&b_value);
+    bigfloat_free(&square);
+    bigfloat_free(&tail);
+    bigfloat_free(&inverse);
+    bigint_free(&denominator);
+    bigint_free(&x);
+    return ok;
+}
+
+
+CalcStatus compute_constant_digits(MpConstant constant, long digits, BigFloat *result) {
+    if (result == NULL || digits < 1 || digits > MP_MAX_DIGITS) return ERROR_INVALID_INPUT;
+
+    bigfloat_init(result);
+    size_t precision = (size_t)digits / MP_BASE_DIGITS + GUARD_LIMBS;
+    bool ok;
+
+    switch (constant) {
+        case MP_E:
+            ok = compute_e(digits, precision, result);
+            break;
+        case MP_PI:
+            ok = compute_pi(digits, precision, result);
+            break;
+        case MP_LN2:
+            ok = compute_ln2(digits, precision, result);
+            break;
+        case MP_SQRT2:
+            ok = compute_sqrt2(precision, result);
+            break;
+        case MP_GAMMA:
+            ok = compute_gamma(digits, precision, result);
+            break;
+        default:
+            return ERROR_INVALID_INPUT;
+    }
+
+    if (!ok) {
+        bigfloat_free(result);
+        return ERROR_MEMORY;
+    }
+    return SUCCESS;
+}
+
+
+static bool flush_digits(FILE *stream, char *buffer, size_t *used) {
+    bool ok = fwrite(buffer, 1, *used, stream) == *used;
+    *used = 0;
+    return ok;
+}
+
+
+// Девять десятичных цифр разряда с номером position (отрицательные - дробная часть)
+static void fraction_group(const BigFloat *value, long long position, char *group) {
+    long long index = position - value->exponent;
+    const BigInt *m = &value->mantissa;
+    uint32_t limb = index >= 0 && index < (long long)m->length ? m->limbs[index] : 0;
+    for (int k = MP_BASE_DIGITS - 1; k >= 0; k--) {
+        group[k] = (char)('0' + limb % 10);
+        limb /= 10;
+    }
+}
+
+
+CalcStatus format_constant_digits(const BigFloat *value, long digits, char *buffer) {
+    if (value == NULL || buffer == NULL || digits < 0) return ERROR_INVALID_INPUT;
+
+    long written = 0;
+    for (long long position = -1; written < digits; position--) {
+        char group[MP_BASE_DIGITS];
+        fraction_group(value, position, group);
+        for (int k = 0; k < MP_BASE_DIGITS && written < digits; k++) {
+            buffer[written++] = group[k];
+        }
+    }
+    buffer[written] = '\0';
+    return SUCCESS;
+}
+
+
+// Цифры выводятся прямо из разрядов по 10^9 через буфер, без построения строки целиком
+CalcStatus write_constant_digits(FILE *stream, const BigFloat *value, long digits) {
+    if (stream == NULL || value == NULL || digits < 0) return ERROR_INVALID_INPUT;
+
+    const BigInt *m = &value->mantissa;
+    long long e = value->exponent;
+    uint64_t integer = 0;
+    for (long long i = (long long)m->length - 1; i >= 0 && i + e >= 0; i--) {
+        integer = integer * MP_BASE + m->limbs[i];
+    }
+    if (m->sign < 0 && m->length > 0) fputc('-', stream);
+    fprintf(stream, "%llu.", (unsigned long long)integer);
+
+    char buffer[WRITER_BUFFER];
+    size_t used = 0;
+    long written = 0;
+
+    for (long long position = -1; written < digits; position--) {
+        char group[MP_BASE_DIGITS];
+        fraction_group(value, position, group);
+        for (int k = 0; k < MP_BASE_DIGITS && written < digits; k++, written++) {
+            buffer[used++] = group[k];
+        }
+        if (used + MP_BASE_DIGITS > sizeof(buffer) && !flush_digits(stream, buffer, &used)) {
+            return ERROR_MEMORY;
+        }
+    }
+
+    buffer[used++] = '\n';
+    return flush_digits(stream, buffer, &used) ? SUCCESS : ERROR_MEMORY;
+}
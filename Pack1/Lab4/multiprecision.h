@@ -0,0 +1,42 @@
+#ifndef MULTIPRECISION_H
+#define MULTIPRECISION_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "constants_calc.h"
+
+#define MP_BASE 1000000000u
+#define MP_BASE_DIGITS 9
+#define MP_MAX_DIGITS 2000000
+
+typedef enum {
+    MP_E,
+    MP_PI,
+    MP_LN2,
+    MP_SQRT2,
+    MP_GAMMA
+} MpConstant;
+
+// Целое со знаком, цифры по основанию 10^9 от младших к старшим
+typedef struct {
+    uint32_t *limbs;
+    size_t length;
+    size_t capacity;
+    int sign;
+} BigInt;
+
+// Значение mantissa * 10^(9 * exponent)
+typedef struct {
+    BigInt mantissa;
+    long long exponent;
+} BigFloat;
+
+// Константа с заданным числом знаков после запятой (бинарное разбиение, умножение через NTT)
+CalcStatus compute_constant_digits(MpConstant constant, long digits, BigFloat *result);
+CalcStatus write_constant_digits(FILE *stream, const BigFloat *value, long digits);
+// Первые digits знаков после запятой в buffer размером не меньше digits + 1
+CalcStatus format_constant_digits(const BigFloat *value, long digits, char *buffer);
+void bigfloat_free(BigFloat *x);
+
+#endif
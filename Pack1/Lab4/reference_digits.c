@@ -0,0 +1,61 @@
+#include "reference_digits.h"
+
+
+// Независимо вычисленные значения (целочисленная арифметика, другие формулы), цифры усечены, не округлены
+const char *const reference_digits[] = {
+    [MP_E] =
+        "7182818284590452353602874713526624977572470936999595749669676277240766303535475945713821785251664274"
+        "2746639193200305992181741359662904357290033429526059563073813232862794349076323382988075319525101901"
+        "1573834187930702154089149934884167509244761460668082264800168477411853742345442437107539077744992069"
+        "5517027618386062613313845830007520449338265602976067371132007093287091274437470472306969772093101416"
+        "9283681902551510865746377211125238978442505695369677078544996996794686445490598793163688923009879312"
+        "7736178215424999229576351482208269895193668033182528869398496465105820939239829488793320362509443117"
+        "3012381970684161403970198376793206832823764648042953118023287825098194558153017567173613320698112509"
+        "9618188159304169035159888851934580727386673858942287922849989208680582574927961048419844436346324496"
+        "8487560233624827041978623209002160990235304369941849146314093431738143640546253152096183690888707016"
+        "7683964243781405927145635490613031072085103837505101157477041718986106873969655212671546889570350354",
+    [MP_PI] =
+        "1415926535897932384626433832795028841971693993751058209749445923078164062862089986280348253421170679"
+        "8214808651328230664709384460955058223172535940812848111745028410270193852110555964462294895493038196"
+        "4428810975665933446128475648233786783165271201909145648566923460348610454326648213393607260249141273"
+        "7245870066063155881748815209209628292540917153643678925903600113305305488204665213841469519415116094"
+        "3305727036575959195309218611738193261179310511854807446237996274956735188575272489122793818301194912"
+        "9833673362440656643086021394946395224737190702179860943702770539217176293176752384674818467669405132"
+        "0005681271452635608277857713427577896091736371787214684409012249534301465495853710507922796892589235"
+        "4201995611212902196086403441815981362977477130996051870721134999999837297804995105973173281609631859"
+        "5024459455346908302642522308253344685035261931188171010003137838752886587533208381420617177669147303"
+        "5982534904287554687311595628638823537875937519577818577805321712268066130019278766111959092164201989",
+    [MP_LN2] =
+        "6931471805599453094172321214581765680755001343602552541206800094933936219696947156058633269964186875"
+        "4200148102057068573368552023575813055703267075163507596193072757082837143519030703862389167347112335"
+        "0115364497955239120475172681574932065155524734139525882950453007095326366642654104239157814952043740"
+        "4303855008019441706416715186447128399681717845469570262716310645461502572074024816377733896385506952"
+        "6066834113727387372292895649354702576265209885969320196505855476470330679365443254763274495125040606"
+        "9438147104689946506220167720424524529612687946546193165174681392672504103802546259656869144192871608"
+        "2938031727143677826548775664850856740776484514644399404614226031930967354025744460703080960850474866"
+        "3852313818167675143866747664789088143714198549423151997354880375165861275352916610007105355824987941"
+        "4729509293113897155998205654392871700072180857610252368892132449713893203784393530887748259701715591"
+        "0708823683627589842589185353024363421436706118923678919237231467232172053401649256872747782344535347",
+    [MP_SQRT2] =
+        "4142135623730950488016887242096980785696718753769480731766797379907324784621070388503875343276415727"
+        "3501384623091229702492483605585073721264412149709993583141322266592750559275579995050115278206057147"
+        "0109559971605970274534596862014728517418640889198609552329230484308714321450839762603627995251407989"
+        "6872533965463318088296406206152583523950547457502877599617298355752203375318570113543746034084988471"
+        "6038689997069900481503054402779031645424782306849293691862158057846311159666871301301561856898723723"
+        "5288509264861249497715421833420428568606014682472077143585487415565706967765372022648544701585880162"
+        "0758474922657226002085584466521458398893944370926591800311388246468157082630100594858704003186480342"
+        "1948972782906410450726368813137398552561173220402450912277002269411275736272804957381089675040183698"
+        "6836845072579936472906076299694138047565482372899718032680247442062926912485905218100445984215059112"
+        "0249441341728531478105803603371077309182869314710171111683916581726889419758716582152128229518488472",
+    [MP_GAMMA] =
+        "5772156649015328606065120900824024310421593359399235988057672348848677267776646709369470632917467495"
+        "1463144724980708248096050401448654283622417399764492353625350033374293733773767394279259525824709491"
+        "6008735203948165670853233151776611528621199501507984793745085705740029921354786146694029604325421519"
+        "0587755352673313992540129674205137541395491116851028079842348775872050384310939973613725530608893312"
+        "6760017247953783675927135157722610273492913940798430103417771778088154957066107501016191663340152278"
+        "9358679654972520362128792265559536696281763887927268013243101047650596370394739495763890657296792960"
+        "1009015125195950922243501409349871228247949747195646976318506676129063811051824197444867836380861749"
+        "4551698927923018773910729457815543160050021828440960537724342032854783670151773943987003023703395183"
+        "2869000155819398804270741154222781971652301107356583396734871765049194181230004065469314299929777956"
+        "9303100503086303418569803231083691640025892970890985486825777364288253954925873629596133298574739302"
+};
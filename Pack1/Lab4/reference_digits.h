@@ -0,0 +1,11 @@
+#ifndef REFERENCE_DIGITS_H
+#define REFERENCE_DIGITS_H
+
+#include "multiprecision.h"
+
+#define REFERENCE_DIGITS 1000
+
+// Первые REFERENCE_DIGITS знаков после запятой каждой константы, индекс - MpConstant
+extern const char *const reference_digits[];
+
+#endif
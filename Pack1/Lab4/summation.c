@@ -0,0 +1,131 @@
+#include "summation.h"
+#include <string.h>
+#include <math.h>
+
+
+void accumulator_init(Accumulator *acc, SummationMode mode) {
+    memset(acc, 0, sizeof(*acc));
+    acc->mode = mode;
+}
+
+
+static void neumaier_add(Accumulator *acc, double x) {
+    double t = acc->sum + x;
+    if (fabs(acc->sum) >= fabs(x)) {
+        acc->compensation += (acc->sum - t) + x;
+    } else {
+        acc->compensation += (x - t) + acc->sum;
+    }
+    acc->sum = t;
+}
+
+
+// Точное сложение двух double с нормализацией: sum - старшая часть, compensation - младшая
+static void double_double_add(Accumulator *acc, double hi, double lo) {
+    double s = acc->sum + hi;
+    double z = s - acc->sum;
+    double e = (acc->sum - (s - z)) + (hi - z);
+    e += acc->compensation + lo;
+    acc->sum = s + e;
+    acc->compensation = e - (acc->sum - s);
+}
+
+
+// Попарное сложение блока на месте, длина - степень двойки
+static double pairwise_reduce(double *x, int length) {
+    for (int width = length / 2; width >= 1; width /= 2) {
+        for (int i = 0; i < width; i++) {
+            x[i] += x[i + width];
+        }
+    }
+    return x[0];
+}
+
+
+static void pairwise_flush(Accumulator *acc) {
+    for (int i = acc->block_count; i < SUMMATION_BLOCK; i++) acc->block[i] = 0.0;
+    double carry = pairwise_reduce(acc->block, SUMMATION_BLOCK);
+    acc->block_count = 0;
+
+    int level = 0;
+    while (level < SUMMATION_LEVELS - 1 && (acc->filled & (1ULL << level))) {
+        carry += acc->levels[level];
+        acc->filled &= ~(1ULL << level);
+        level++;
+    }
+    if (acc->filled & (1ULL << level)) carry += acc->levels[level];
+    acc->levels[level] = carry;
+    acc->filled |= 1ULL << level;
+}
+
+
+void accumulator_add(Accumulator *acc, double x) {
+    switch (acc->mode) {
+        case SUMMATION_NEUMAIER:
+            neumaier_add(acc, x);
+            break;
+        case SUMMATION_DOUBLE_DOUBLE:
+            double_double_add(acc, x, 0.0);
+            break;
+        case SUMMATION_PAIRWISE:
+            acc->block[acc->block_count++] = x;
+            if (acc->block_count == SUMMATION_BLOCK) pairwise_flush(acc);
+            break;
+    }
+}
+
+
+// По полосам: TwoSum без ветвлений, сумма и ошибка каждой полосы копятся отдельно
+static void lanes_two_sum(const double *restrict x, size_t n, double *restrict sum, double *restrict error) {
+    for (size_t i = 0; i + SUMMATION_LANES <= n; i += SUMMATION_LANES) {
+        for (int j = 0; j < SUMMATION_LANES; j++) {
+            double t = sum[j] + x[i + j];
+            double z = t - sum[j];
+            error[j] += (sum[j] - (t - z)) + (x[i + j] - z);
+            sum[j] = t;
+        }
+    }
+}
+
+
+void accumulator_add_array(Accumulator *acc, const double *x, size_t n) {
+    if (acc->mode == SUMMATION_PAIRWISE) {
+        while (n > 0) {
+            size_t count = SUMMATION_BLOCK - acc->block_count;
+            if (count > n) count = n;
+            memcpy(acc->block + acc->block_count, x, count * sizeof(double));
+            acc->block_count += (int)count;
+            x += count;
+            n -= count;
+            if (acc->block_count == SUMMATION_BLOCK) pairwise_flush(acc);
+        }
+        return;
+    }
+
+    double sum[SUMMATION_LANES] = {0.0}, error[SUMMATION_LANES] = {0.0};
+    size_t body = n - n % SUMMATION_LANES;
+    lanes_two_sum(x, body, sum, error);
+
+    for (int j = 0; j < SUMMATION_LANES; j++) {
+        if (acc->mode == SUMMATION_DOUBLE_DOUBLE) {
+            double_double_add(acc, sum[j], error[j]);
+        } else {
+            neumaier_add(acc, sum[j]);
+            acc->compensation += error[j];
+        }
+    }
+    for (size_t i = body; i < n; i++) accumulator_add(acc, x[i]);
+}
+
+
+double accumulator_result(const Accumulator *acc) {
+    if (acc->mode != SUMMATION_PAIRWISE) return acc->sum + acc->compensation;
+
+    double block[SUMMATION_BLOCK] = {0.0};
+    memcpy(block, acc->block, acc->block_count * sizeof(double));
+    double total = pairwise_reduce(block, SUMMATION_BLOCK);
+    for (int level = 0; level < SUMMATION_LEVELS; level++) {
+        if (acc->filled & (1ULL << level)) total += acc->levels[level];
+    }
+    return total;
+}
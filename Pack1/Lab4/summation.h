@@ -0,0 +1,36 @@
+#ifndef SUMMATION_H
+#define SUMMATION_H
+
+#include <stddef.h>
+
+#define SUMMATION_LANES 4
+#define SUMMATION_BLOCK 32
+#define SUMMATION_LEVELS 64
+
+typedef enum {
+    SUMMATION_NEUMAIER,
+    SUMMATION_PAIRWISE,
+    SUMMATION_DOUBLE_DOUBLE
+} SummationMode;
+
+// Накопитель суммы с компенсацией ошибки округления.
+// NEUMAIER и DOUBLE_DOUBLE хранят сумму как sum + compensation,
+// PAIRWISE складывает блоки по SUMMATION_BLOCK членов каскадом (двоичный счётчик уровней).
+// Копия попарного режима лежит в Pack1/Lab6/summation.c
+typedef struct {
+    SummationMode mode;
+    double sum;
+    double compensation;
+    double block[SUMMATION_BLOCK];
+    int block_count;
+    double levels[SUMMATION_LEVELS];
+    unsigned long long filled;
+} Accumulator;
+
+void accumulator_init(Accumulator *acc, SummationMode mode);
+void accumulator_add(Accumulator *acc, double x);
+// Массив складывается по SUMMATION_LANES независимым полосам, внутренний цикл векторизуется
+void accumulator_add_array(Accumulator *acc, const double *x, size_t n);
+double accumulator_result(const Accumulator *acc);
+
+#endif
@@ -1,4 +1,5 @@
 #include "integral.h"
+#include "summation.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -51,7 +52,10 @@ IntegralStatus integrate_trapezoidal(MathFunction f, double a, double b,
     for (int iter = 1; iter <= MAX_ITERATIONS; iter++) {
         *iterations = iter;
         
-        double sum = 0.0;
+        Accumulator sum;
+        accumulator_init(&sum);
+        double values[SUMMATION_BUFFER];
+        int buffered = 0;
         int valid_points = 0;
         
         for (int i = 1; i <= n; i++) {
@@ -63,16 +67,21 @@ IntegralStatus integrate_trapezoidal(MathFunction f, double a, double b,
                 continue;
             }
             
-            sum += fx;
+            values[buffered++] = fx;
+            if (buffered == SUMMATION_BUFFER) {
+                accumulator_add_array(&sum, values, buffered);
+                buffered = 0;
+            }
             valid_points++;
         }
+        accumulator_add_array(&sum, values, buffered);
         
         if (valid_points == 0) {
             *result = T_new;
             return INTEGRAL_ERROR_MATH_DOMAIN;
         }
         
-        T_new = 0.5 * (T_old + h * sum);
+        T_new = 0.5 * (T_old + h * accumulator_result(&sum));
         
         if (iter > 1 && fabs(T_new - T_old) < eps) {
             *result = T_new;
@@ -6,6 +6,7 @@
 #define MAX_ITERATIONS 1000000
 #define DEFAULT_EPS 1e-6
 #define SINGULARITY_EPS 1e-12
+#define SUMMATION_BUFFER 256
 
 typedef enum {
     INTEGRAL_SUCCESS = 0,
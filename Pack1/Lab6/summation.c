@@ -0,0 +1,61 @@
+#include "summation.h"
+#include <string.h>
+
+// Урезанная копия Pack1/Lab4/summation.c (только режим SUMMATION_PAIRWISE)
+
+
+void accumulator_init(Accumulator *acc) {
+    memset(acc, 0, sizeof(*acc));
+}
+
+
+// Попарное сложение блока на месте, длина - степень двойки
+static double pairwise_reduce(double *x, int length) {
+    for (int width = length / 2; width >= 1; width /= 2) {
+        for (int i = 0; i < width; i++) {
+            x[i] += x[i + width];
+        }
+    }
+    return x[0];
+}
+
+
+static void pairwise_flush(Accumulator *acc) {
+    for (int i = acc->block_count; i < SUMMATION_BLOCK; i++) acc->block[i] = 0.0;
+    double carry = pairwise_reduce(acc->block, SUMMATION_BLOCK);
+    acc->block_count = 0;
+
+    int level = 0;
+    while (level < SUMMATION_LEVELS - 1 && (acc->filled & (1ULL << level))) {
+        carry += acc->levels[level];
+        acc->filled &= ~(1ULL << level);
+        level++;
+    }
+    if (acc->filled & (1ULL << level)) carry += acc->levels[level];
+    acc->levels[level] = carry;
+    acc->filled |= 1ULL << level;
+}
+
+
+void accumulator_add_array(Accumulator *acc, const double *x, size_t n) {
+    while (n > 0) {
+        size_t count = SUMMATION_BLOCK - acc->block_count;
+        if (count > n) count = n;
+        memcpy(acc->block + acc->block_count, x, count * sizeof(double));
+        acc->block_count += (int)count;
+        x += count;
+        n -= count;
+        if (acc->block_count == SUMMATION_BLOCK) pairwise_flush(acc);
+    }
+}
+
+
+double accumulator_result(const Accumulator *acc) {
+    double block[SUMMATION_BLOCK] = {0.0};
+    memcpy(block, acc->block, acc->block_count * sizeof(double));
+    double total = pairwise_reduce(block, SUMMATION_BLOCK);
+    for (int level = 0; level < SUMMATION_LEVELS; level++) {
+        if (acc->filled & (1ULL << level)) total += acc->levels[level];
+    }
+    return total;
+}
@@ -0,0 +1,24 @@
+#ifndef SUMMATION_H
+#define SUMMATION_H
+
+#include <stddef.h>
+
+// Урезанная копия Pack1/Lab4/summation.h: здесь нужен только попарный режим.
+// Исправления вносятся сначала в Lab4, затем переносятся сюда
+
+#define SUMMATION_BLOCK 32
+#define SUMMATION_LEVELS 64
+
+// Попарная сумма: блоки по SUMMATION_BLOCK членов складываются каскадом (двоичный счётчик уровней)
+typedef struct {
+    double block[SUMMATION_BLOCK];
+    int block_count;
+    double levels[SUMMATION_LEVELS];
+    unsigned long long filled;
+} Accumulator;
+
+void accumulator_init(Accumulator *acc);
+void accumulator_add_array(Accumulator *acc, const double *x, size_t n);
+double accumulator_result(const Accumulator *acc);
+
+#endif